@@ -0,0 +1,70 @@
+#ifndef CANONICAL_HPP
+#define CANONICAL_HPP
+
+#include <bit>
+#include <array>
+#include <bitset>
+#include <vector>
+#include <cstdint>
+#include "permutation.hpp"
+
+// Finds the smallest image of a set of vertices under the symmetries of
+// the hypercube, without going through the whole group. The order is the
+// one siab3 and siab4 use: vertex 0 is compared first, and a vertex in
+// the set is larger than one that isn't.
+
+// The image of a set S under a symmetry g contains v iff S contains g(v).
+// Vertex 0 of the image only depends on the mask of g, and vertices
+// 2^k to 2^(k+1) - 1 only depend on the mask and where the first k + 1
+// axes go. So the search picks the mask first, then one axis at a time,
+// and at each step throws away every choice that doesn't give the smallest
+// block of the image so far. Whatever is left at the end maps the set to
+// its smallest image, so there are as many of them as symmetries that map
+// the set onto itself.
+
+template<unsigned N>
+struct canonicalizer
+{
+	typedef std::bitset<(1 << N)> vertexSet;
+	
+	struct result
+	{
+		vertexSet form;
+		
+		// The number of symmetries that map the input onto itself.
+		std::size_t stabilizerSize;
+		
+		// A symmetry whose image of the input is the form.
+		symmetry<N> transform;
+	};
+	
+	static result canonicalize(const vertexSet& vertices);
+	
+	// Same as checking canonicalize(vertices).form == vertices,
+	// but gives up as soon as any image is smaller.
+	static bool isCanonical(const vertexSet& vertices);
+	
+	private:
+	
+	// A block of the image, vertices 2^k to 2^(k+1) - 1 for some k. These are
+	// stored with the first vertex in the highest bit of the first word, so that
+	// comparing blocks is the same as comparing the arrays.
+	constexpr static unsigned blockWords = N <= 7 ? 1 : (1 << (N - 1)) / 64;
+	typedef std::array<uint64_t, blockWords> block;
+	
+	struct partial
+	{
+		symmetry<N> sym;
+		
+		// Axes that have already been used by sym.
+		unsigned used;
+	};
+	
+	// If reject is true, this returns false as soon as an image smaller
+	// than the input itself shows up.
+	static bool search(const vertexSet& vertices, bool reject, result& out);
+};
+
+#include "canonical.tpp"
+
+#endif
@@ -0,0 +1,114 @@
+#include "canonical.hpp"
+
+template<unsigned N>
+typename canonicalizer<N>::result canonicalizer<N>::canonicalize(const vertexSet& vertices)
+{
+	result out;
+	search(vertices, false, out);
+	return out;
+}
+
+template<unsigned N>
+bool canonicalizer<N>::isCanonical(const vertexSet& vertices)
+{
+	result out;
+	return search(vertices, true, out);
+}
+
+template<unsigned N>
+bool canonicalizer<N>::search(const vertexSet& vertices, bool reject, result& out)
+{
+	std::vector<partial> current, next;
+	
+	// Vertex 0 of the image is whether the set contains the mask, so the
+	// smallest choice is any mask not in the set, if there is one.
+	const bool first = reject ? vertices[0] : vertices.all();
+	
+	for (unsigned mask = 0; mask < vertices.size(); mask++)
+	{
+		if (vertices[mask] == first)
+		{
+			current.push_back({ symmetry<N>(), 0 });
+			current.back().sym.mask = mask;
+		}
+		else if (reject && !vertices[mask])
+		{
+			return false;
+		}
+	}
+	
+	out.form.reset();
+	out.form[0] = first;
+	
+	// [j] is where the axes chosen so far send vertex j.
+	std::array<unsigned, (1 << N) / 2> axisMap;
+	
+	for (unsigned k = 0; k < N; k++)
+	{
+		const unsigned size = 1 << k;
+		
+		// The smallest block so far. When rejecting, this starts out as
+		// the input's own block, since the input is its own image.
+		block best {};
+		bool haveBest = reject;
+		
+		if (reject)
+		{
+			for (unsigned j = 0; j < size; j++)
+			{
+				best[j / 64] |= uint64_t(vertices[size + j]) << (63 - j % 64);
+			}
+		}
+		
+		next.clear();
+		
+		for (const partial& p : current)
+		{
+			axisMap[0] = 0;
+			for (unsigned j = 1; j < size; j++)
+			{
+				axisMap[j] = axisMap[j & (j - 1)] | (1u << p.sym.axes[std::countr_zero(j)]);
+			}
+			
+			for (unsigned x = 0; x < N; x++)
+			{
+				if (p.used & (1 << x)) continue;
+				
+				block b {};
+				for (unsigned j = 0; j < size; j++)
+				{
+					const unsigned image = p.sym.mask ^ axisMap[j] ^ (1 << x);
+					b[j / 64] |= uint64_t(vertices[image]) << (63 - j % 64);
+				}
+				
+				if (!haveBest || b < best)
+				{
+					if (reject) return false;
+					
+					best = b;
+					haveBest = true;
+					next.clear();
+				}
+				
+				if (b == best)
+				{
+					next.push_back(p);
+					next.back().sym.axes[k] = x;
+					next.back().used |= 1 << x;
+				}
+			}
+		}
+		
+		for (unsigned j = 0; j < size; j++)
+		{
+			out.form[size + j] = (best[j / 64] >> (63 - j % 64)) & 1;
+		}
+		
+		std::swap(current, next);
+	}
+	
+	out.stabilizerSize = current.size();
+	out.transform = current.front().sym;
+	
+	return true;
+}
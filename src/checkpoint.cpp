@@ -0,0 +1,72 @@
+#include <stdexcept>
+#include <filesystem>
+#include "checkpoint.hpp"
+
+// Marks the start of every checkpoint file, and the format version.
+constexpr uint32_t magic = 0x42414953; // "SIAB"
+constexpr uint32_t version = 1;
+
+checkpointWriter::checkpointWriter(const std::string& _file, uint32_t program, uint32_t dimension) :
+	file(_file), stream(_file + ".tmp", std::ios::binary | std::ios::trunc)
+{
+	write(magic);
+	write(version);
+	write(program);
+	write(dimension);
+}
+
+void checkpointWriter::commit()
+{
+	stream.close();
+	
+	if (!stream)
+		throw std::runtime_error("could not write checkpoint " + file + ".tmp");
+	
+	std::filesystem::rename(file + ".tmp", file);
+}
+
+checkpointReader::checkpointReader(const std::string& _file, uint32_t program, uint32_t dimension) :
+	file(_file), stream(_file, std::ios::binary)
+{
+	if (!stream)
+		throw std::runtime_error("could not open checkpoint " + file);
+	
+	if (read<uint32_t>() != magic || read<uint32_t>() != version)
+		throw std::runtime_error(file + " is not a checkpoint, or is from another version");
+	
+	if (read<uint32_t>() != program || read<uint32_t>() != dimension)
+		throw std::runtime_error(file + " is from a different program or dimension");
+}
+
+void checkpointReader::check()
+{
+	if (!stream)
+		throw std::runtime_error("checkpoint " + file + " is truncated");
+}
+
+uint64_t checkpointReader::bytesLeft()
+{
+	const auto position = stream.tellg();
+	stream.seekg(0, std::ios::end);
+	const auto end = stream.tellg();
+	stream.seekg(position);
+	check();
+	
+	return end - position;
+}
+
+checkpointTimer::checkpointTimer(unsigned seconds, unsigned _stride) :
+	interval(std::chrono::seconds(seconds)), last(std::chrono::steady_clock::now()),
+	stride(_stride), calls(0) {}
+
+bool checkpointTimer::due()
+{
+	if (++calls % stride != 0) return false;
+	
+	auto now = std::chrono::steady_clock::now();
+	
+	if (now - last < interval) return false;
+	
+	last = now;
+	return true;
+}
@@ -0,0 +1,145 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+// Binary checkpoint files for long searches. Every file starts with a
+// header giving the program that wrote it and the dimension, so a
+// checkpoint can't be resumed by the wrong program or size. Everything
+// after that is up to the program, written as raw values in order.
+// Values are in native byte order, checkpoints are not meant to be
+// moved between machines.
+
+class checkpointWriter
+{
+	public:
+	
+	// Starts writing a checkpoint. The data goes to a temporary file,
+	// which only replaces the old checkpoint on commit(), so a crash
+	// mid-write keeps the previous one intact.
+	checkpointWriter(const std::string& file, uint32_t program, uint32_t dimension);
+	
+	template<class T>
+	void write(const T& value)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+	
+	// Writes the size, then the contents.
+	template<class T>
+	void writeVector(const std::vector<T>& values)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		write<uint64_t>(values.size());
+		stream.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+	}
+	
+	// Writes the induced vertices of a hypercube (either representation).
+	template<class cube>
+	void writeCube(const cube& h)
+	{
+		std::vector<uint16_t> vertices;
+		for (unsigned i = 0; i < cube::numVertices; i++)
+		{
+			if (h.isInduced(i)) vertices.push_back(i);
+		}
+		writeVector(vertices);
+	}
+	
+	// Throws std::runtime_error if the file couldn't be written.
+	void commit();
+	
+	private:
+	
+	std::string file;
+	std::ofstream stream;
+};
+
+class checkpointReader
+{
+	public:
+	
+	// Throws std::runtime_error if the file can't be opened, or if it
+	// was written by a different program or dimension.
+	checkpointReader(const std::string& file, uint32_t program, uint32_t dimension);
+	
+	// These throw std::runtime_error if the file ends early.
+	template<class T>
+	T read()
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		T value;
+		stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+		check();
+		return value;
+	}
+	
+	template<class T>
+	std::vector<T> readVector()
+	{
+		const uint64_t size = read<uint64_t>();
+		
+		// A corrupted size would otherwise try to allocate far more
+		// than the file could hold.
+		if (size > bytesLeft() / sizeof(T))
+			throw std::runtime_error("checkpoint " + file + " has an invalid length");
+		
+		std::vector<T> values(size);
+		stream.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(T));
+		check();
+		return values;
+	}
+	
+	// Reads a hypercube written by writeCube().
+	template<class cube>
+	cube readCube()
+	{
+		cube h;
+		for (unsigned v : readVector<uint16_t>())
+		{
+			if (v >= cube::numVertices)
+				throw std::runtime_error("checkpoint " + file + " has an invalid vertex");
+			h.induce(v);
+		}
+		return h;
+	}
+	
+	private:
+	
+	void check();
+	
+	// The number of bytes after the current position.
+	uint64_t bytesLeft();
+	
+	std::string file;
+	std::ifstream stream;
+};
+
+// Decides when the next checkpoint is due. Reading the clock isn't free,
+// so it is only looked at every 'stride' calls to due().
+class checkpointTimer
+{
+	public:
+	
+	checkpointTimer(unsigned seconds, unsigned stride = 4096);
+	
+	// Returns true (and restarts the interval) if it has been at least
+	// the given number of seconds since the last checkpoint.
+	bool due();
+	
+	private:
+	
+	std::chrono::steady_clock::duration interval;
+	std::chrono::steady_clock::time_point last;
+	unsigned stride;
+	unsigned calls;
+};
+
+#endif
@@ -18,74 +18,71 @@ if X is not a subset of Y, and Y is not a subset of X, then F and G are unordere
 
 Forms are grouped by number of vertices and current endpoint. From there, remove
 any forms that have a smaller form, and keep only one copy of equivalent forms.
+Each group has a dominanceIndex over the footprints, so finding the forms a new
+one is smaller or larger than doesn't need to look at the whole group. --scan
+compares against every form in the group instead.
+
+With --checkpoint=FILE, every stored form and the counts so far are saved to
+FILE every --interval=S seconds (default 600), and --resume continues from it.
 */
 
 #include <array>
-#include <stack>
+#include <algorithm>
+#include <bit>
 #include <ctime>
 #include <bitset>
 #include <iostream>
+#include <filesystem>
 #include <unordered_set>
+#include "options.hpp"
+#include "checkpoint.hpp"
+#include "dimension.hpp"
 #include "hypercube.hpp"
-#include "permutation.hpp"
-
-// MAX_DIM will be compiled in
+#include "packedHypercube.hpp"
+#include "workPool.hpp"
+#include "dominanceIndex.hpp"
+#include "reachable.hpp"
 
-constexpr unsigned numVertices = 1 << MAX_DIM;
+// The dimension is given with --dim=N. Everything below is templated on
+// the hypercube representation (which carries the dimension), so either
+// hypercube or packedHypercube can be used (selected with --packed).
 
+template<class cube>
 struct snake
 {
 	// Mutable, to allow this to be modified while in the set.
 	// The hash value is only dependent on h, so it can
 	// 'pretend' to be another snake temporarily.
-	mutable hypercube<MAX_DIM> h;
+	mutable cube h;
 	
-	std::bitset<numVertices> footprint;
+	std::bitset<cube::numVertices> footprint;
 	
+	unsigned endpoint;
 	unsigned highestDim;
 	
+	// The stored form this one was made from, and the ones made from this
+	// one, as a list through nextSibling. Erasing a form erases all of its
+	// children as well, so following the links finds them without
+	// rebuilding each child and looking it up.
+	mutable const snake* parent;
+	mutable const snake* firstChild;
+	mutable const snake* nextSibling;
+	
+	// Set when the form is erased. It is only taken out of snakeClasses
+	// by the next compact(), so anything going through snakeClasses has
+	// to skip these.
+	mutable bool erased;
+	
 	// Looks at the current state of h to construct a snake.
-	snake(const hypercube<MAX_DIM>& _h, unsigned lastAddition, unsigned highestDimension)
-		: h(_h), highestDim(highestDimension)
-	{
-		// DFS search
-		std::stack<unsigned> toBeSearched;
-		
-		// Start as true, set any vertices that can be reached to false.
-		footprint.set();
-		
-		for (unsigned adj : hypercube<MAX_DIM>::adjLists[lastAddition])
-		{
-			if (h.vertices[adj].effectiveDegree == 1 && !h.vertices[adj].induced)
-			{
-				toBeSearched.push(adj);
-			}
-		}
-		
-		while(!toBeSearched.empty())
-		{
-			unsigned next = toBeSearched.top();
-			toBeSearched.pop();
-			
-			if (footprint[next])
-			{
-				footprint.reset(next);
-				
-				for (unsigned adj : hypercube<MAX_DIM>::adjLists[next])
-				{
-					if (h.vertices[adj].effectiveDegree == 0 && !h.vertices[adj].induced)
-					{
-						toBeSearched.push(adj);
-					}
-				}
-			}
-		}
-	}
+	snake(const cube& _h, unsigned lastAddition, unsigned highestDimension)
+		: h(_h), footprint(~toBitset<cube::dimension>(reachableRegion(_h, lastAddition))),
+		  endpoint(lastAddition), highestDim(highestDimension),
+		  parent(nullptr), firstChild(nullptr), nextSibling(nullptr), erased(false) {}
 	
 	friend std::ostream& operator<<(std::ostream& stream, const snake& s)
 	{
 		stream << s.h;
-		for (unsigned i = 0; i < numVertices; ++i)
+		for (unsigned i = 0; i < cube::numVertices; ++i)
 		{
 			stream << (s.footprint[i] ? 'O' : '_') << ' ';
 		}
@@ -119,64 +116,152 @@ struct snake
 	}
 };
 
+template<class cube>
 struct snake_hash
 {
-	std::size_t operator()(const snake& s) const
+	std::size_t operator()(const snake<cube>& s) const
 	{
-		// This implementation is based off djb2, found at
-		// http://www.cse.yorku.ca/~oz/hash.html
-		
-		// This probably isn't the best hash function for this
-		// purpose, but it should be good enough.
-		
-		std::size_t hash = 5381;
-		
-		for (const auto& c : s.h.vertices)
-		{
-			hash = ((hash << 5) + hash) + c.induced; /* hash * 33 + c */
-		}
-		
-		return hash;
+		return s.h.hash();
 	}
 };
 
+template<class cube>
+using snakeSet = std::unordered_set<snake<cube>, snake_hash<cube>>;
+
 // First index is # of vertices, second is end vertex, last vector contains snakes.
-std::array<std::array<std::unordered_set<snake, snake_hash>,numVertices>,numVertices + 1> snakeClasses;
+template<class cube>
+std::array<std::array<snakeSet<cube>,cube::numVertices>,cube::numVertices + 1> snakeClasses;
+
+// The footprints of snakeClasses, with the same indexes. Pointers to
+// elements of an unordered_set stay valid until they are erased.
+template<class cube>
+using snakeIndex = dominanceIndex<cube::numVertices, const snake<cube>*>;
+
+template<class cube>
+std::array<std::array<snakeIndex<cube>,cube::numVertices>,cube::numVertices + 1> dominance;
+
+// Set by --scan, to not use the dominance index.
+bool scan = false;
 
-// Recursively removes a snake and any of its children from snakeClasses.
-void eraseRecursive(std::unordered_set<snake, snake_hash>::iterator iter, unsigned lastAddition, unsigned highestDim)
+// Forms erased since the last compact().
+template<class cube>
+std::vector<const snake<cube>*> erasedForms;
+
+// The number of vertices of the forms being stored, set by run for each
+// level. Forms with this many vertices have no children yet, so when they
+// are erased, they are taken out of snakeClasses right away rather than
+// left for compact(). The forms left are then laid out in their sets (and
+// iterated) the same way as if the erased ones had never been stored, which
+// decides which of two equivalent forms is kept later on.
+template<class cube>
+unsigned newLevel = 0;
+
+// Stores s, as a child of 'parent' if it has one.
+template<class cube>
+void storeSnake(const snake<cube>& s, const snake<cube>* parent = nullptr)
 {
-	// Do the recursive deletes
-	const unsigned stop = std::min((unsigned)MAX_DIM,highestDim + 1);
-	for (unsigned i = 0; i < stop; ++i)
+	auto [iter, added] = snakeClasses<cube>[s.h.numInduced][s.endpoint].insert(s);
+	
+	if (!added) return;
+	
+	if (parent)
+	{
+		iter->parent = parent;
+		iter->nextSibling = parent->firstChild;
+		parent->firstChild = &*iter;
+	}
+	
+	if (!scan)
+	{
+		dominance<cube>[s.h.numInduced][s.endpoint].insert(iter->footprint, &*iter);
+	}
+}
+
+// Erases a form and every form made from it. They are only marked as
+// erased (and taken out of the index) here, so nothing is freed and
+// any pointers to them stay valid until compact().
+template<class cube>
+void eraseTree(const snake<cube>* root)
+{
+	// Kept between calls, so that it doesn't allocate every time.
+	static std::vector<const snake<cube>*> toErase;
+	toErase.push_back(root);
+	
+	while (!toErase.empty())
 	{
-		unsigned adj = hypercube<MAX_DIM>::adjLists[lastAddition][i];
+		const snake<cube>* s = toErase.back();
+		toErase.pop_back();
 		
-		// We need to check that the neighbor isn't induced specifically
-		// for the case of the starting vertex's first expansion.
-		if (iter->h.vertices[adj].effectiveDegree == 1 && !iter->h.vertices[adj].induced)
+		if (s->erased) continue;
+		
+		if (!scan)
 		{
-			iter->h.induce(adj);
-			
-			// Lookup h, if it exists, then do a recursive call.
-			auto& snakeClass = snakeClasses[iter->h.numInduced][adj];
-			
-			if (auto search = snakeClass.find(*iter); search != snakeClass.end())
+			dominance<cube>[s->h.numInduced][s->endpoint].erase(s->footprint, s);
+		}
+		
+		if (s->h.numInduced == newLevel<cube>)
+		{
+			// A live parent would still point to it. An erased one is
+			// never walked again, its children were pushed above.
+			if (s->parent && !s->parent->erased)
 			{
-				eraseRecursive(search, adj, highestDim + (i == highestDim));
+				const snake<cube>** link = &s->parent->firstChild;
+				while (*link != s) link = &(*link)->nextSibling;
+				*link = s->nextSibling;
 			}
 			
-			iter->h.reduce(adj);
+			auto& snakeClass = snakeClasses<cube>[s->h.numInduced][s->endpoint];
+			snakeClass.erase(snakeClass.find(*s));
+			continue;
+		}
+		
+		s->erased = true;
+		erasedForms<cube>.push_back(s);
+		
+		for (const snake<cube>* child = s->firstChild; child; child = child->nextSibling)
+		{
+			toErase.push_back(child);
+		}
+	}
+}
+
+// Takes every erased form out of snakeClasses.
+template<class cube>
+void compact()
+{
+	auto& erased = erasedForms<cube>;
+	
+	// The children of an erased form are erased too, so only the first
+	// erased form on each branch can have a parent that is still there.
+	// Those are unlinked first, since they are about to be freed.
+	for (const snake<cube>* s : erased)
+	{
+		if (!s->parent || s->parent->erased) continue;
+		
+		const snake<cube>** link = &s->parent->firstChild;
+		while (*link)
+		{
+			if ((*link)->erased)
+				*link = (*link)->nextSibling;
+			else
+				link = &(*link)->nextSibling;
 		}
 	}
 	
-	// Then erase the item
-	snakeClasses[iter->h.numInduced][lastAddition].erase(iter);
+	for (const snake<cube>* s : erased)
+	{
+		auto& snakeClass = snakeClasses<cube>[s->h.numInduced][s->endpoint];
+		snakeClass.erase(snakeClass.find(*s));
+	}
+	
+	erased.clear();
 }
 
-void emplaceSnake(const hypercube<MAX_DIM>& h, unsigned lastAddition, unsigned highestDim)
+template<class cube>
+void emplaceSnakeScan(const snake<cube>& s, const snake<cube>* parent)
 {
-	snake s(h, lastAddition, highestDim);
+	const cube& h = s.h;
+	const unsigned lastAddition = s.endpoint;
 	
 	// Find the first element that does not compare unordered to s.
 	// Default value needed due to no default constructor.
@@ -185,13 +270,13 @@ void emplaceSnake(const hypercube<MAX_DIM>& h, unsigned lastAddition, unsigned h
 	// Loop through each size
 	for (unsigned nv = 1; nv <= h.numInduced; ++nv)
 	{
-		auto& snakeClass = snakeClasses[nv][lastAddition];
+		auto& snakeClass = snakeClasses<cube>[nv][lastAddition];
 		
 		// Find the first snake in this class that doesn't compare unordered to s.
 		auto iter = std::find_if(snakeClass.begin(), snakeClass.end(),
-			[&result, &s](const snake& other)
+			[&result, &s](const snake<cube>& other)
 			{
-				return (result = s <=> other) != std::partial_ordering::unordered;
+				return !other.erased && (result = s <=> other) != std::partial_ordering::unordered;
 			}
 		);
 		
@@ -200,49 +285,32 @@ void emplaceSnake(const hypercube<MAX_DIM>& h, unsigned lastAddition, unsigned h
 		{
 			if (result == std::partial_ordering::less)
 			{
-				// If s is smaller than the given element, recursively erase the element
-				{
-					auto element = iter++;
-					eraseRecursive(element, lastAddition, element->highestDim);
-				}
-				
-				// Then continue scanning for any other snakes larger than s.
+				// If s is smaller than the given element, erase the element,
+				// then continue scanning for any other snakes larger than s.
+				// Erasing can take a form out of the set, so the iterator is
+				// moved on first. Its children are all in later sets.
 				while (iter != snakeClass.end())
 				{
-					if (s <= *iter)
-					{
-						auto element = iter++;
-						eraseRecursive(element, lastAddition, element->highestDim);
-					}
-					else
-					{
-						++iter;
-					}
+					auto element = iter++;
+					if (!element->erased && s <= *element) eraseTree(&*element);
 				}
 				
 				// Remove any other smaller item that may be larger than s.
 				// Increase nv initially, since the current amount has already had pruning.
 				while(++nv <= h.numInduced)
 				{
-					auto& snakeClass2 = snakeClasses[nv][lastAddition];
+					auto& snakeClass2 = snakeClasses<cube>[nv][lastAddition];
 					
 					for (auto iter2 = snakeClass2.begin(); iter2 != snakeClass2.end();)
 					{
-						if (s <= *iter2)
-						{
-							auto element = iter2++;
-							eraseRecursive(element, lastAddition, element->highestDim);
-						}
-						else
-						{
-							++iter2;
-						}
+						auto element = iter2++;
+						if (!element->erased && s <= *element) eraseTree(&*element);
 					}
 				}
 				
 				// Only add this after all erasing has been done, since s <= s and thus would
 				// get erased.
-				snakeClasses[h.numInduced][lastAddition].emplace(s);
+				storeSnake(s, parent);
 				
 				return;
 			}
@@ -256,17 +324,58 @@ void emplaceSnake(const hypercube<MAX_DIM>& h, unsigned lastAddition, unsigned h
 	}
 	
 	// If all other snakes with the same endpoint compare unordered, then keep s.
-	snakeClasses[h.numInduced][lastAddition].emplace(s);
+	storeSnake(s, parent);
 }
 
-std::array<unsigned long long, numVertices + 1> sizeCounts;
+template<class cube>
+void emplaceSnake(const cube& h, unsigned lastAddition, unsigned highestDim, const snake<cube>* parent)
+{
+	snake<cube> s(h, lastAddition, highestDim);
+	
+	if (scan)
+	{
+		emplaceSnakeScan(s, parent);
+		return;
+	}
+	
+	// Forms are added one level at a time, so the only stored forms that
+	// can be larger than or equivalent to s have the same number of vertices,
+	// and a footprint inside that of s.
+	if (dominance<cube>[h.numInduced][lastAddition].anySubsetOf(s.footprint)) return;
+	
+	// Otherwise remove every form s is smaller than, which are the ones
+	// with a footprint containing that of s. Erasing a form also erases its
+	// children, which have more vertices, so each size is looked up only
+	// once the ones before it are done.
+	std::vector<const snake<cube>*> larger;
+	for (unsigned nv = 1; nv <= h.numInduced; ++nv)
+	{
+		larger.clear();
+		dominance<cube>[nv][lastAddition].supersetsOf(s.footprint, larger);
+		
+		for (const snake<cube>* other : larger)
+		{
+			eraseTree(other);
+		}
+	}
+	
+	storeSnake(s, parent);
+}
+
+// Number of forms of each size.
+template<class cube>
+using sizeArray = std::array<unsigned long long, cube::numVertices + 1>;
 
+template<class cube>
+sizeArray<cube> sizeCounts;
+
+template<class cube>
 unsigned long long getSnakesOfSize(unsigned size)
 {
-	if (sizeCounts[size]) return sizeCounts[size];
+	if (sizeCounts<cube>[size]) return sizeCounts<cube>[size];
 	
 	unsigned long long result = 0;
-	for (const auto& snakeClass : snakeClasses[size])
+	for (const auto& snakeClass : snakeClasses<cube>[size])
 	{
 		result += snakeClass.size();
 	}
@@ -275,113 +384,568 @@ unsigned long long getSnakesOfSize(unsigned size)
 
 unsigned breakPoint;
 
-void enumerateRecursive(hypercube<MAX_DIM>& h, unsigned lastAddition, unsigned highestDim)
+template<class cube>
+void enumerateRecursive(cube& h, unsigned lastAddition, unsigned highestDim, sizeArray<cube>& counts)
 {
-	++sizeCounts[h.numInduced];
+	++counts[h.numInduced];
 	
 	if (h.numInduced == breakPoint) return;
 	
 	// By the nature of the order of the vertices, index in the adjacency
 	// list is also the dimension number.
-	const unsigned stop = std::min((unsigned)MAX_DIM,highestDim + 1);
+	const unsigned stop = std::min(cube::dimension,highestDim + 1);
 	for (unsigned i = 0; i < stop; ++i)
 	{
-		unsigned adj = hypercube<MAX_DIM>::adjLists[lastAddition][i];
+		unsigned adj = cube::adjLists[lastAddition][i];
 		
 		// We need to check that the neighbor isn't induced specifically
 		// for the case of the starting vertex's first expansion.
-		if (h.vertices[adj].effectiveDegree == 1 && !h.vertices[adj].induced)
+		if (h.extendable(adj))
 		{
 			h.induce(adj);
 			
-			enumerateRecursive(h, adj, highestDim + (i == highestDim));
+			enumerateRecursive(h, adj, highestDim + (i == highestDim), counts);
 			
 			h.reduce(adj);
 		}
 	}
 }
 
-void enumerate(hypercube<MAX_DIM>& h, unsigned lastAddition, unsigned highestDim)
+template<class cube>
+void enumerate(const snake<cube>& parent)
 {
+	cube& h = parent.h;
+	const unsigned lastAddition = parent.endpoint;
+	const unsigned highestDim = parent.highestDim;
+	
 	// By the nature of the order of the vertices, index in the adjacency
 	// list is also the dimension number.
-	const unsigned stop = std::min((unsigned)MAX_DIM,highestDim + 1);
+	const unsigned stop = std::min(cube::dimension,highestDim + 1);
 	for (unsigned i = 0; i < stop; ++i)
 	{
-		unsigned adj = hypercube<MAX_DIM>::adjLists[lastAddition][i];
+		unsigned adj = cube::adjLists[lastAddition][i];
 		
 		// We need to check that the neighbor isn't induced specifically
 		// for the case of the starting vertex's first expansion.
-		if (h.vertices[adj].effectiveDegree == 1 && !h.vertices[adj].induced)
+		if (h.extendable(adj))
 		{
 			h.induce(adj);
 			
-			emplaceSnake(h, adj, highestDim + (i == highestDim));
+			emplaceSnake(h, adj, highestDim + (i == highestDim), &parent);
 			
 			h.reduce(adj);
 		}
 	}
 }
 
-int main(int argn, char** args)
+// Set by --threads. With more than one, each level is expanded by expandLevel.
+unsigned numThreads = 1;
+
+// A form made by expandLevel that hasn't been stored yet.
+template<class cube>
+struct candidate
+{
+	snake<cube> s;
+	const snake<cube>* parent;
+	
+	// The stored forms with fewer vertices that s is smaller than, as of
+	// the start of the level.
+	std::vector<const snake<cube>*> larger;
+};
+
+// Expands every form with nv vertices on numThreads threads, in three steps:
+// 1. Each endpoint's forms are expanded by their own task, into a buffer of
+//    their own, without touching snakeClasses.
+// 2. For each new form, a task finds the stored forms with nv or fewer
+//    vertices that it is smaller than.
+// 3. The new forms are stored the same way emplaceSnake does, on one thread,
+//    in the order the sequential version makes them.
+// Step 3 has to be in order, since a form can be erased before the
+// sequential version gets to expanding it. Its children would never have
+// been made, so they can't be allowed to throw out other forms. The forms
+// with nv or fewer vertices only get erased during the level, so the ones
+// found in step 2 are the ones the sequential version would find, other
+// than those already erased, and erasing those again does nothing.
+// The result is the same as the sequential version, form for form.
+template<class cube>
+void expandLevel(unsigned nv)
 {
-	if (argn != 3)
+	constexpr unsigned numVertices = cube::numVertices;
+	
+	// [v] is the new forms made from the forms ending at v, in the order
+	// the sequential version makes them.
+	std::vector<std::vector<candidate<cube>>> made(numVertices);
+	
+	workPool expandPool(numThreads);
+	for (unsigned endpoint = 0; endpoint < numVertices; ++endpoint)
 	{
-		std::cerr << "Error: requires 'pruned' and 'semipruned' as arguments\n";
-		return 1;
+		expandPool.submit([&made, nv, endpoint](unsigned)
+		{
+			// Each task only changes (and puts back) the forms ending at its
+			// own endpoint.
+			for (auto& s : snakeClasses<cube>[nv][endpoint])
+			{
+				if (s.erased) continue;
+				
+				const unsigned stop = std::min(cube::dimension, s.highestDim + 1);
+				for (unsigned i = 0; i < stop; ++i)
+				{
+					unsigned adj = cube::adjLists[endpoint][i];
+					
+					if (s.h.extendable(adj))
+					{
+						s.h.induce(adj);
+						made[endpoint].push_back({
+							snake<cube>(s.h, adj, s.highestDim + (i == s.highestDim)), &s, {}});
+						s.h.reduce(adj);
+					}
+				}
+			}
+		});
+	}
+	expandPool.run();
+	
+	// Nothing is stored or erased until step 3, so this only reads.
+	workPool lookupPool(numThreads);
+	for (unsigned endpoint = 0; endpoint < numVertices; ++endpoint)
+	{
+		lookupPool.submit([&made, nv, endpoint](unsigned)
+		{
+			for (auto& c : made[endpoint])
+			{
+				for (unsigned k = 1; k <= nv; ++k)
+				{
+					dominance<cube>[k][c.s.endpoint].supersetsOf(c.s.footprint, c.larger);
+				}
+			}
+		});
 	}
+	lookupPool.run();
 	
-	const unsigned pruned = atoi(args[1]);
-	breakPoint = atoi(args[2]);
+	std::vector<const snake<cube>*> larger;
+	
+	for (unsigned endpoint = 0; endpoint < numVertices; ++endpoint)
+	{
+		// A form's children are next to each other, and whether it is
+		// still there is looked at once, before the first one, which is
+		// when the sequential version would expand it.
+		const snake<cube>* parent = nullptr;
+		bool alive = false;
+		
+		for (const auto& c : made[endpoint])
+		{
+			if (c.parent != parent)
+			{
+				parent = c.parent;
+				alive = !parent->erased;
+			}
+			
+			if (!alive) continue;
+			
+			auto& level = dominance<cube>[nv + 1][c.s.endpoint];
+			
+			if (level.anySubsetOf(c.s.footprint)) continue;
+			
+			for (const snake<cube>* other : c.larger)
+			{
+				eraseTree(other);
+			}
+			
+			larger.clear();
+			level.supersetsOf(c.s.footprint, larger);
+			for (const snake<cube>* other : larger)
+			{
+				eraseTree(other);
+			}
+			
+			storeSnake(c.s, c.parent);
+		}
+	}
 	
+	compact<cube>();
+}
+
+// Program number for checkpoint files. (0x40 was the format before the
+// bucket counts were saved.)
+constexpr uint32_t checkpointProgram = 0x41;
+
+// Set by --checkpoint, --interval and --resume. The checkpoint file is
+// empty if checkpointing is off.
+std::string checkpointFile;
+unsigned checkpointInterval = 600;
+bool resume = false;
+
+// Where the search is. Before 'pruned', forms with 'level' vertices and
+// an endpoint before 'endpoint' have been expanded. At 'pruned', the
+// forms left in snakeClasses are the ones that haven't been counted yet.
+struct progress
+{
+	uint32_t level;
+	uint32_t endpoint;
+};
+
+// Saves the arguments, progress, counts so far, and every stored form.
+// While counting the rest, 'done' forms at the start of snakeClasses[pruned]
+// are left out, so they aren't counted twice.
+
+// Which of two equivalent forms is kept depends on the order the sets are
+// iterated in, so the forms are saved in that order, along with the number
+// of buckets of each set, for loadCheckpoint to lay the sets out the same.
+template<class cube>
+void saveCheckpoint(unsigned pruned, progress at, unsigned long long done = 0)
+{
+	compact<cube>();
+	
+	checkpointWriter writer(checkpointFile, checkpointProgram, cube::dimension);
+	
+	writer.write<uint32_t>(pruned);
+	writer.write<uint32_t>(breakPoint);
+	writer.write(at);
+	writer.write(sizeCounts<cube>);
+	
+	for (unsigned nv = 1; nv <= cube::numVertices; ++nv)
+	{
+		for (unsigned endpoint = 0; endpoint < cube::numVertices; ++endpoint)
+		{
+			const auto& snakeClass = snakeClasses<cube>[nv][endpoint];
+			
+			unsigned long long skip = 0;
+			if (nv == pruned)
+			{
+				skip = std::min<unsigned long long>(done, snakeClass.size());
+				done -= skip;
+			}
+			
+			writer.write<uint64_t>(snakeClass.bucket_count());
+			writer.write<uint64_t>(snakeClass.size() - skip);
+			for (const auto& s : snakeClass)
+			{
+				if (skip > 0)
+				{
+					--skip;
+					continue;
+				}
+				
+				writer.write<uint16_t>(s.highestDim);
+				writer.writeCube(s.h);
+			}
+		}
+	}
+	
+	writer.commit();
+}
+
+// Throws if a loaded form isn't one the search could have stored: the
+// right number of vertices, ending at an induced vertex, and made from a
+// stored parent the same way enumerate() would have.
+template<class cube>
+void checkLoadedForm(const snake<cube>& s, unsigned nv)
+{
+	const auto invalid = []()
+	{
+		return std::runtime_error("checkpoint " + checkpointFile + " has an invalid form");
+	};
+	
+	if (s.h.numInduced != nv || !s.h.isInduced(s.endpoint) || s.highestDim > cube::dimension)
+		throw invalid();
+	
+	if (nv == 1)
+	{
+		if (s.endpoint != 0 || s.highestDim != 0) throw invalid();
+		return;
+	}
+	
+	if (!s.parent) throw invalid();
+	
+	const snake<cube>& parent = *s.parent;
+	const unsigned dim = std::countr_zero(s.endpoint ^ parent.endpoint);
+	
+	if (dim > parent.highestDim || s.highestDim != parent.highestDim + (dim == parent.highestDim))
+		throw invalid();
+}
+
+template<class cube>
+progress loadCheckpoint(unsigned pruned)
+{
+	checkpointReader reader(checkpointFile, checkpointProgram, cube::dimension);
+	
+	if (reader.read<uint32_t>() != pruned || reader.read<uint32_t>() != breakPoint)
+		throw std::runtime_error("checkpoint " + checkpointFile + " used different arguments");
+	
+	auto at = reader.read<progress>();
+	sizeCounts<cube> = reader.read<sizeArray<cube>>();
+	
+	if (at.level < 1 || at.level > std::max(pruned, 1u) || at.endpoint > cube::numVertices)
+		throw std::runtime_error("checkpoint " + checkpointFile + " has invalid progress");
+	
+	std::vector<snake<cube>> forms;
+	
+	for (unsigned nv = 1; nv <= cube::numVertices; ++nv)
+	{
+		for (unsigned endpoint = 0; endpoint < cube::numVertices; ++endpoint)
+		{
+			auto& snakeClass = snakeClasses<cube>[nv][endpoint];
+			
+			// No set gets anywhere near this many, so it can only be a
+			// corrupted file.
+			const auto buckets = reader.read<uint64_t>();
+			if (buckets > (uint64_t(1) << 28))
+				throw std::runtime_error("checkpoint " + checkpointFile + " has an invalid bucket count");
+			
+			forms.clear();
+			for (auto count = reader.read<uint64_t>(); count > 0; --count)
+			{
+				unsigned highestDim = reader.read<uint16_t>();
+				cube h = reader.readCube<cube>();
+				
+				if (!h.isInduced(endpoint) || h.numInduced != nv)
+					throw std::runtime_error("checkpoint " + checkpointFile + " has an invalid form");
+				
+				forms.emplace_back(h, endpoint, highestDim);
+			}
+			
+			// Going in reverse with the same number of buckets puts every
+			// form back in the same place, since each one goes in at the
+			// start of its bucket, and a bucket that was empty goes first.
+			if (buckets > 1) snakeClass.rehash(buckets);
+			
+			for (auto s = forms.rbegin(); s != forms.rend(); ++s)
+			{
+				if (snakeClass.count(*s))
+					throw std::runtime_error("checkpoint " + checkpointFile + " has a form twice");
+				
+				storeSnake(*s);
+			}
+		}
+	}
+	
+	// The links between forms aren't saved, so each form is linked to its
+	// parent again, which is the form without its endpoint, ending at the
+	// one induced neighbor of the endpoint. Every form but the first has
+	// one, since erasing a form erases the ones made from it.
+	for (unsigned nv = 1; nv <= cube::numVertices; ++nv)
+	{
+		for (unsigned endpoint = 0; endpoint < cube::numVertices; ++endpoint)
+		{
+			for (const auto& s : snakeClasses<cube>[nv][endpoint])
+			{
+				unsigned induced = 0;
+				for (unsigned adj : cube::adjLists[endpoint])
+				{
+					if (!s.h.isInduced(adj)) continue;
+					
+					++induced;
+					if (nv == 1 || s.parent) continue;
+					
+					auto& parents = snakeClasses<cube>[nv - 1][adj];
+					
+					s.h.reduce(endpoint);
+					if (auto parent = parents.find(s); parent != parents.end())
+					{
+						s.parent = &*parent;
+						s.nextSibling = parent->firstChild;
+						parent->firstChild = &s;
+					}
+					s.h.induce(endpoint);
+				}
+				
+				if (induced != (nv > 1))
+					throw std::runtime_error("checkpoint " + checkpointFile + " has an invalid form");
+				
+				checkLoadedForm(s, nv);
+			}
+		}
+	}
+	
+	return at;
+}
+
+template<class cube>
+void run(unsigned pruned)
+{
 	auto start_time = clock();
 	
-	// Enumerate pruned first
-	hypercube<MAX_DIM> h;
-	h.induce(0);
+	checkpointTimer timer(checkpointInterval, 1);
+	progress at = { 1, 0 };
 	
-	emplaceSnake(h,0,0);
+	if (resume)
+	{
+		at = loadCheckpoint<cube>(pruned);
+		std::cout << "Resuming at " << at.level << std::endl;
+	}
+	else
+	{
+		// Enumerate pruned first
+		cube h;
+		h.induce(0);
+		
+		emplaceSnake<cube>(h,0,0,nullptr);
+	}
 	
-	for (unsigned nv = 1; nv < pruned && nv <= numVertices; ++nv)
+	for (unsigned nv = at.level; nv < pruned && nv <= cube::numVertices; ++nv)
 	{
 		std::cout << nv << "..." << std::flush;
 		
-		for (unsigned endpoint = 0; endpoint < numVertices; ++endpoint)
+		newLevel<cube> = nv + 1;
+		
+		if (numThreads > 1)
+		{
+			// A level that was partly done sequentially is finished on one thread.
+			if (nv != at.level || at.endpoint == 0)
+			{
+				expandLevel<cube>(nv);
+				
+				if (!checkpointFile.empty() && timer.due())
+				{
+					saveCheckpoint<cube>(pruned, { nv + 1, 0 });
+				}
+				
+				std::cout << " done" << std::endl;
+				continue;
+			}
+		}
+		
+		for (unsigned endpoint = nv == at.level ? at.endpoint : 0; endpoint < cube::numVertices; ++endpoint)
 		{
-			for (auto& s : snakeClasses[nv][endpoint])
+			for (const auto& s : snakeClasses<cube>[nv][endpoint])
 			{
-				enumerate(s.h, endpoint, s.highestDim);
+				if (!s.erased) enumerate(s);
+			}
+			
+			if (!checkpointFile.empty() && timer.due())
+			{
+				saveCheckpoint<cube>(pruned, { nv, endpoint + 1 });
 			}
 		}
 		
+		compact<cube>();
+		
 		std::cout << " done" << std::endl;
 	}
 	
-	if (pruned <= numVertices)
+	if (pruned <= cube::numVertices)
 	{
 		std::cout << "Enumerating rest..." << std::flush;
 		
-		for (unsigned endpoint = 0; endpoint < numVertices; ++endpoint)
+		// Every form left is counted by a task of its own, into the counts
+		// of the thread running it. One endpoint is done at a time, so that
+		// a checkpoint can say how many forms are done.
+		workPool pool(numThreads);
+		std::vector<sizeArray<cube>> threadCounts(pool.size());
+		
+		unsigned long long done = 0;
+		
+		for (unsigned endpoint = 0; endpoint < cube::numVertices; ++endpoint)
 		{
-			for (auto& s : snakeClasses[pruned][endpoint])
+			auto& snakeClass = snakeClasses<cube>[pruned][endpoint];
+			
+			for (auto& s : snakeClass)
+			{
+				pool.submit([&s, &threadCounts](unsigned thread)
+				{
+					enumerateRecursive(s.h, s.endpoint, s.highestDim, threadCounts[thread]);
+				});
+			}
+			pool.run();
+			
+			for (auto& counts : threadCounts)
+			{
+				for (unsigned nv = 0; nv <= cube::numVertices; ++nv)
+				{
+					sizeCounts<cube>[nv] += counts[nv];
+				}
+				counts = {};
+			}
+			
+			done += snakeClass.size();
+			
+			std::cout << "\rEnumerating rest... " << endpoint + 1 << '/' << cube::numVertices << std::flush;
+			
+			if (!checkpointFile.empty() && timer.due())
 			{
-				enumerateRecursive(s.h, endpoint, s.highestDim);
+				saveCheckpoint<cube>(pruned, { pruned, 0 }, done);
 			}
 		}
 		
 		std::cout << " done" << std::endl;
 	}
 	
+	// The search is done, so the checkpoint is of no use anymore.
+	if (!checkpointFile.empty()) std::filesystem::remove(checkpointFile);
+	
 	std::cout << "\nFinished in " << (float)(clock()-start_time)/(CLOCKS_PER_SEC) << " seconds\n\n";
 	
 	// Print in graph-friendly format
 	unsigned long long total = 0;
-	for (unsigned nv = 0; nv < numVertices; ++nv)
+	for (unsigned nv = 0; nv < cube::numVertices; ++nv)
 	{
-		unsigned result = getSnakesOfSize(nv);
+		unsigned result = getSnakesOfSize<cube>(nv);
 		total += result;
 		if (result)
 			std::cout << '(' << nv << ",log(" << result << ")),";
 	}
-	std::cout << "\b \n\n(" << MAX_DIM << ",log(" << total << "))" << std::endl;
+	std::cout << "\b \n\n(" << cube::dimension << ",log(" << total << "))" << std::endl;
+}
+
+int main(int argn, char** args)
+{
+	options opts(argn, args);
+	
+	if (opts.positional().size() != 2)
+	{
+		std::cerr << "Error: requires 'pruned' and 'semipruned' as arguments\n";
+		return 1;
+	}
+	
+	if (auto flag = opts.unknown({"dim", "packed", "checkpoint", "interval", "resume",
+		"scan", "threads"}); !flag.empty())
+	{
+		std::cerr << "Error: unknown flag --" << flag << std::endl;
+		return 1;
+	}
+	
+	const unsigned dim = opts.get("dim", 0);
+	
+	if (dim < 1 || dim > 8)
+	{
+		std::cerr << "Error: requires --dim=N, for N from 1 to 8" << std::endl;
+		return 1;
+	}
+	
+	const unsigned pruned = atoi(opts.positional()[0].c_str());
+	breakPoint = atoi(opts.positional()[1].c_str());
+	
+	checkpointFile = opts.getString("checkpoint", "");
+	checkpointInterval = opts.get("interval", checkpointInterval);
+	resume = opts.has("resume");
+	scan = opts.has("scan");
+	numThreads = std::max(opts.get("threads", 1), 1u);
+	
+	if (scan && numThreads > 1)
+	{
+		std::cerr << "Error: --scan can't be used with --threads" << std::endl;
+		return 1;
+	}
+	
+	if (resume && checkpointFile.empty())
+	{
+		std::cerr << "Error: --resume requires --checkpoint=FILE" << std::endl;
+		return 1;
+	}
+	
+	try
+	{
+		withDimension<1, 8>(dim, [&]<unsigned N>()
+		{
+			if (opts.has("packed"))
+				run<packedHypercube<N>>(pruned);
+			else
+				run<hypercube<N>>(pruned);
+		});
+	}
+	catch (std::runtime_error& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
 }
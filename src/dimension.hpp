@@ -0,0 +1,20 @@
+#ifndef DIMENSION_HPP
+#define DIMENSION_HPP
+
+// Every program takes the dimension at runtime (--dim=N), but the search
+// code is templated on it so each size still gets its own specialized
+// hot loops. This turns the runtime value into a template argument.
+
+// Calls f.template operator()<dim>(), for lambdas of the form
+// []<unsigned N>() { ... }. dim must be between Min and Max.
+template<unsigned Min, unsigned Max, class F>
+auto withDimension(unsigned dim, F&& f)
+{
+	if constexpr (Min < Max)
+	{
+		if (dim != Min) return withDimension<Min + 1, Max>(dim, f);
+	}
+	return f.template operator()<Min>();
+}
+
+#endif
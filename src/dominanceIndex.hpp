@@ -0,0 +1,81 @@
+#ifndef DOMINANCE_INDEX_HPP
+#define DOMINANCE_INDEX_HPP
+
+#include <bitset>
+#include <vector>
+#include <cstddef>
+
+// Stores values keyed by sets of bits, and answers subset and superset
+// queries without looking at every key.
+
+// The keys live in a binary tree. Each internal node splits its keys on
+// one bit, and the leaves hold up to leafSize keys each. A query only has
+// to go down both sides of a node when the answer could be on either side:
+// a subset of X can't have a bit X doesn't, and a superset of X must have
+// every bit X has. The split bit is picked when a leaf gets too big, as the
+// one that splits its keys closest to evenly, so the tree adapts to
+// whichever bits actually vary.
+
+// Nodes are never merged back together after erasing, since the keys that
+// get erased tend to be replaced with similar ones.
+
+template<std::size_t bits, class T>
+class dominanceIndex
+{
+	public:
+	
+	typedef std::bitset<bits> key;
+	
+	dominanceIndex();
+	
+	void insert(const key& k, const T& value);
+	
+	// Removes the given key and value, if they are in the index.
+	void erase(const key& k, const T& value);
+	
+	// Whether any key in the index is a subset of x (including x itself).
+	bool anySubsetOf(const key& x) const;
+	
+	// Adds the value of every key that is a superset of x to 'out'.
+	void supersetsOf(const key& x, std::vector<T>& out) const;
+	
+	std::size_t size() const { return count; }
+	
+	private:
+	
+	constexpr static unsigned leafSize = 32;
+	constexpr static unsigned leaf = bits;
+	
+	struct entry
+	{
+		key k;
+		T value;
+	};
+	
+	struct node
+	{
+		// The bit this node splits on, or 'leaf' if it holds entries.
+		unsigned bit;
+		
+		// Indexes into nodes, for keys without and with 'bit'.
+		unsigned children[2];
+		
+		std::vector<entry> entries;
+	};
+	
+	std::vector<node> nodes;
+	std::size_t count;
+	
+	// Finds the leaf a key belongs in.
+	unsigned leafFor(const key& k) const;
+	
+	// Splits a leaf that has gotten too big into two.
+	void split(unsigned n);
+	
+	bool anySubsetOf(unsigned n, const key& x) const;
+	void supersetsOf(unsigned n, const key& x, std::vector<T>& out) const;
+};
+
+#include "dominanceIndex.tpp"
+
+#endif
@@ -0,0 +1,145 @@
+#include "dominanceIndex.hpp"
+
+template<std::size_t bits, class T>
+dominanceIndex<bits,T>::dominanceIndex() : count(0) {}
+
+template<std::size_t bits, class T>
+unsigned dominanceIndex<bits,T>::leafFor(const key& k) const
+{
+	unsigned n = 0;
+	while (nodes[n].bit != leaf)
+	{
+		n = nodes[n].children[k[nodes[n].bit]];
+	}
+	return n;
+}
+
+template<std::size_t bits, class T>
+void dominanceIndex<bits,T>::insert(const key& k, const T& value)
+{
+	// The root is only made once something is inserted, so that empty
+	// indexes don't allocate anything.
+	if (nodes.empty()) nodes.push_back({leaf, {0, 0}, {}});
+	
+	const unsigned n = leafFor(k);
+	nodes[n].entries.push_back({k, value});
+	++count;
+	
+	if (nodes[n].entries.size() > leafSize) split(n);
+}
+
+template<std::size_t bits, class T>
+void dominanceIndex<bits,T>::erase(const key& k, const T& value)
+{
+	if (nodes.empty()) return;
+	
+	auto& entries = nodes[leafFor(k)].entries;
+	
+	for (auto& e : entries)
+	{
+		if (e.value == value)
+		{
+			e = std::move(entries.back());
+			entries.pop_back();
+			--count;
+			return;
+		}
+	}
+}
+
+template<std::size_t bits, class T>
+void dominanceIndex<bits,T>::split(unsigned n)
+{
+	const auto& entries = nodes[n].entries;
+	
+	// Find the bit that is set in closest to half of the keys.
+	unsigned best = leaf;
+	std::size_t bestDistance = entries.size();
+	
+	for (unsigned b = 0; b < bits; ++b)
+	{
+		std::size_t set = 0;
+		for (const auto& e : entries) set += e.k[b];
+		
+		// A bit that is set in all or none of the keys doesn't split anything.
+		if (set == 0 || set == entries.size()) continue;
+		
+		const std::size_t distance = set * 2 > entries.size()
+			? set * 2 - entries.size() : entries.size() - set * 2;
+		
+		if (distance < bestDistance)
+		{
+			best = b;
+			bestDistance = distance;
+		}
+	}
+	
+	// Every key is the same, so there is nothing to split on.
+	if (best == leaf) return;
+	
+	const unsigned first = nodes.size();
+	nodes.push_back({leaf, {0, 0}, {}});
+	nodes.push_back({leaf, {0, 0}, {}});
+	
+	// The push_backs may have moved the nodes, so look it up again.
+	node& parent = nodes[n];
+	for (auto& e : parent.entries)
+	{
+		nodes[first + e.k[best]].entries.push_back(std::move(e));
+	}
+	
+	parent.bit = best;
+	parent.children[0] = first;
+	parent.children[1] = first + 1;
+	std::vector<entry>().swap(parent.entries);
+}
+
+template<std::size_t bits, class T>
+bool dominanceIndex<bits,T>::anySubsetOf(const key& x) const
+{
+	return !nodes.empty() && anySubsetOf(0, x);
+}
+
+template<std::size_t bits, class T>
+bool dominanceIndex<bits,T>::anySubsetOf(unsigned n, const key& x) const
+{
+	const node& current = nodes[n];
+	
+	if (current.bit == leaf)
+	{
+		for (const auto& e : current.entries)
+		{
+			if ((e.k & ~x).none()) return true;
+		}
+		return false;
+	}
+	
+	// Keys with the bit can only be subsets if x has it too.
+	return anySubsetOf(current.children[0], x)
+		|| (x[current.bit] && anySubsetOf(current.children[1], x));
+}
+
+template<std::size_t bits, class T>
+void dominanceIndex<bits,T>::supersetsOf(const key& x, std::vector<T>& out) const
+{
+	if (!nodes.empty()) supersetsOf(0, x, out);
+}
+
+template<std::size_t bits, class T>
+void dominanceIndex<bits,T>::supersetsOf(unsigned n, const key& x, std::vector<T>& out) const
+{
+	const node& current = nodes[n];
+	
+	if (current.bit == leaf)
+	{
+		for (const auto& e : current.entries)
+		{
+			if ((x & ~e.k).none()) out.push_back(e.value);
+		}
+		return;
+	}
+	
+	// Keys without the bit can only be supersets if x doesn't have it either.
+	if (!x[current.bit]) supersetsOf(current.children[0], x, out);
+	supersetsOf(current.children[1], x, out);
+}
@@ -11,6 +11,7 @@
 template <unsigned N>
 struct hypercube
 {
+	constexpr static unsigned dimension = N;
 	constexpr static unsigned numVertices = 1 << N;
 	
 	private:
@@ -40,10 +41,21 @@ struct hypercube
 	void induce(unsigned);
 	void reduce(unsigned);
 	
+	// Queries on a single vertex. A vertex is 'extendable' if it is not
+	// induced and has exactly one induced neighbor, so it can be used to
+	// extend a snake ending at that neighbor. A vertex is 'open' if it
+	// is not induced and has no induced neighbors.
+	bool isInduced(unsigned) const;
+	bool extendable(unsigned) const;
+	bool open(unsigned) const;
+	
+	// Hash of the set of induced vertices.
+	std::size_t hash() const;
+	
 	bool operator==(const hypercube& other) const;
 	
 	// Prints which vertices are induced as Xs, and those that are not
-	// as _s, all on one line.
+	// as _s, all on one line (without ending it).
 	template<unsigned M>
 	friend std::ostream& operator<<(std::ostream& stream, const hypercube<M>& h);
 };
@@ -42,6 +42,40 @@ void hypercube<N>::reduce(unsigned i)
 	}
 }
 
+template<unsigned N>
+bool hypercube<N>::isInduced(unsigned i) const
+{
+	return vertices[i].induced;
+}
+
+template<unsigned N>
+bool hypercube<N>::extendable(unsigned i) const
+{
+	return vertices[i].effectiveDegree == 1 && !vertices[i].induced;
+}
+
+template<unsigned N>
+bool hypercube<N>::open(unsigned i) const
+{
+	return vertices[i].effectiveDegree == 0 && !vertices[i].induced;
+}
+
+template<unsigned N>
+std::size_t hypercube<N>::hash() const
+{
+	// This implementation is based off djb2, found at
+	// http://www.cse.yorku.ca/~oz/hash.html
+	
+	std::size_t hash = 5381;
+	
+	for (const auto& v : vertices)
+	{
+		hash = ((hash << 5) + hash) + v.induced; /* hash * 33 + c */
+	}
+	
+	return hash;
+}
+
 template<unsigned N>
 bool hypercube<N>::operator==(const hypercube& other) const
 {
@@ -62,5 +96,5 @@ std::ostream& operator<<(std::ostream& stream, const hypercube<N>& h)
 	{
 		stream << (v.induced ? "X " : "_ ");
 	}
-	return stream << "| " << h.numInduced << " vertices" << std::endl;
+	return stream << "| " << h.numInduced << " vertices";
 }
@@ -0,0 +1,43 @@
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "mappedFile.hpp"
+
+mappedFile::mappedFile(const std::string& path) : address(nullptr), length(0)
+{
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		throw std::runtime_error("could not open " + path);
+	}
+	
+	struct stat info;
+	if (fstat(fd, &info) != 0)
+	{
+		close(fd);
+		throw std::runtime_error("could not read the size of " + path);
+	}
+	
+	length = info.st_size;
+	
+	// Mapping 0 bytes isn't allowed, but there's nothing to map anyways.
+	if (length > 0)
+	{
+		address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+	
+	// The mapping keeps its own reference to the file.
+	close(fd);
+	
+	if (address == MAP_FAILED)
+	{
+		throw std::runtime_error("could not map " + path);
+	}
+}
+
+mappedFile::~mappedFile()
+{
+	if (address) munmap(address, length);
+}
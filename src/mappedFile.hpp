@@ -0,0 +1,30 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <string>
+#include <cstddef>
+
+// A read-only memory mapping of a whole file. The pages are only read in
+// when they are touched, and the OS can drop them again whenever it needs
+// the memory, since they are backed by the file.
+class mappedFile
+{
+	public:
+	
+	// Throws std::runtime_error if the file can't be opened or mapped.
+	mappedFile(const std::string& path);
+	~mappedFile();
+	
+	mappedFile(const mappedFile&) = delete;
+	mappedFile& operator=(const mappedFile&) = delete;
+	
+	const void* data() const { return address; }
+	std::size_t size() const { return length; }
+	
+	private:
+	
+	void* address;
+	std::size_t length;
+};
+
+#endif
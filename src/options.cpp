@@ -0,0 +1,60 @@
+#include <cstdlib>
+#include <algorithm>
+#include "options.hpp"
+
+options::options(int argn, char** arguments)
+{
+	for (int i = 1; i < argn; i++)
+	{
+		std::string arg = arguments[i];
+		
+		if (arg.starts_with("--"))
+		{
+			auto split = arg.find('=');
+			std::string name = arg.substr(2, split - 2);
+			
+			flags[name] = split == std::string::npos ? "" : arg.substr(split + 1);
+			flagNames.push_back(name);
+		}
+		else
+		{
+			args.push_back(arg);
+		}
+	}
+}
+
+bool options::has(const std::string& name) const
+{
+	return flags.contains(name);
+}
+
+unsigned options::get(const std::string& name, unsigned def) const
+{
+	auto search = flags.find(name);
+	
+	if (search == flags.end() || search->second.empty()) return def;
+	
+	return std::strtoul(search->second.c_str(), nullptr, 10);
+}
+
+std::string options::getString(const std::string& name, const std::string& def) const
+{
+	auto search = flags.find(name);
+	
+	return search == flags.end() ? def : search->second;
+}
+
+const std::vector<std::string>& options::positional() const
+{
+	return args;
+}
+
+std::string options::unknown(std::initializer_list<std::string> known) const
+{
+	for (const auto& name : flagNames)
+	{
+		if (std::find(known.begin(), known.end(), name) == known.end())
+			return name;
+	}
+	return "";
+}
@@ -0,0 +1,42 @@
+#ifndef OPTIONS_HPP
+#define OPTIONS_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <initializer_list>
+
+// Minimal command line parsing shared by the programs. Arguments of
+// the form "--name" or "--name=value" are flags, and anything else is
+// a positional argument.
+class options
+{
+	public:
+	
+	options(int argn, char** args);
+	
+	// Returns true if a flag was given, with or without a value.
+	bool has(const std::string&) const;
+	
+	// Returns the value of a flag, or the default if it was not given.
+	unsigned get(const std::string&, unsigned) const;
+	std::string getString(const std::string&, const std::string&) const;
+	
+	// Positional arguments, in order.
+	const std::vector<std::string>& positional() const;
+	
+	// Returns the first flag that is not in the given list, or an empty
+	// string if all flags are known.
+	std::string unknown(std::initializer_list<std::string>) const;
+	
+	private:
+	
+	std::unordered_map<std::string, std::string> flags;
+	
+	// Kept in order for error messages.
+	std::vector<std::string> flagNames;
+	
+	std::vector<std::string> args;
+};
+
+#endif
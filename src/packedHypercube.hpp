@@ -0,0 +1,79 @@
+#ifndef PACKED_HYPERCUBE_HPP
+#define PACKED_HYPERCUBE_HPP
+
+#include <bit>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include "hypercube.hpp"
+
+// Bit-sliced version of hypercube, with the same interface.
+// Vertex i is bit (i % 64) of word (i / 64). Rather than storing
+// a degree per vertex, the degrees are stored as binary counters
+// spread across bitplanes, so degree[k] holds bit k of the degree
+// of every vertex. Inducing a vertex then only takes a ripple-carry
+// add over a few words, and the whole state is a handful of words
+// (for N = 8, 160 bytes instead of 512).
+template <unsigned N>
+struct packedHypercube
+{
+	typedef uint64_t word;
+	
+	constexpr static unsigned dimension = N;
+	constexpr static unsigned numVertices = 1 << N;
+	constexpr static unsigned numWords = (numVertices + 63) / 64;
+	
+	// Number of bits needed to count up to N induced neighbors.
+	constexpr static unsigned numPlanes = std::bit_width(N);
+	
+	constexpr static auto adjLists = hypercube<N>::adjLists;
+	
+	private:
+	// Dimensions below this are within a word, the rest are across words.
+	constexpr static unsigned wordDims = N < 6 ? N : 6;
+	
+	constexpr static std::array<word, 64> makeLocalNeighbors();
+	
+	// [i] is the set of neighbors of bit i that are in the same word.
+	constexpr static auto localNeighbors = makeLocalNeighbors();
+	
+	void increment(unsigned w, word mask);
+	void decrement(unsigned w, word mask);
+	
+	public:
+	
+	std::array<word, numWords> induced;
+	std::array<std::array<word, numWords>, numPlanes> degree;
+	unsigned numInduced;
+	
+	packedHypercube();
+	
+	// Reduce is the inverse of induce.
+	void induce(unsigned);
+	void reduce(unsigned);
+	
+	// See hypercube for the meaning of these.
+	bool isInduced(unsigned) const;
+	bool extendable(unsigned) const;
+	bool open(unsigned) const;
+	
+	// Returns the set of vertices in word w with a degree of exactly 1
+	// that are not induced.
+	word extendableWord(unsigned w) const;
+	
+	// Returns the set of vertices in word w that are not induced
+	// and have no induced neighbors.
+	word openWord(unsigned w) const;
+	
+	std::size_t hash() const;
+	
+	bool operator==(const packedHypercube& other) const;
+	
+	// Same format as hypercube.
+	template<unsigned M>
+	friend std::ostream& operator<<(std::ostream& stream, const packedHypercube<M>& h);
+};
+
+#include "packedHypercube.tpp"
+
+#endif
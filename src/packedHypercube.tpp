@@ -0,0 +1,144 @@
+#include "packedHypercube.hpp"
+
+template<unsigned N>
+packedHypercube<N>::packedHypercube() : induced{}, degree{}, numInduced(0) {}
+
+template<unsigned N>
+constexpr std::array<uint64_t, 64> packedHypercube<N>::makeLocalNeighbors()
+{
+	std::array<word, 64> result {};
+	
+	for (unsigned i = 0; i < 64; i++)
+	{
+		for (unsigned j = 0; j < wordDims; j++)
+		{
+			result[i] |= word(1) << (i ^ (1 << j));
+		}
+	}
+	
+	return result;
+}
+
+// Adds 1 to the degree of each vertex in the mask.
+template<unsigned N>
+void packedHypercube<N>::increment(unsigned w, word mask)
+{
+	for (unsigned k = 0; k < numPlanes; k++)
+	{
+		word carry = degree[k][w] & mask;
+		degree[k][w] ^= mask;
+		mask = carry;
+	}
+}
+
+// Subtracts 1 from the degree of each vertex in the mask.
+template<unsigned N>
+void packedHypercube<N>::decrement(unsigned w, word mask)
+{
+	for (unsigned k = 0; k < numPlanes; k++)
+	{
+		word borrow = ~degree[k][w] & mask;
+		degree[k][w] ^= mask;
+		mask = borrow;
+	}
+}
+
+template<unsigned N>
+void packedHypercube<N>::induce(unsigned i)
+{
+	const unsigned w = i / 64, b = i % 64;
+	
+	induced[w] |= word(1) << b;
+	++numInduced;
+	
+	increment(w, localNeighbors[b]);
+	for (unsigned j = wordDims; j < N; j++)
+	{
+		increment(w ^ (1 << (j - 6)), word(1) << b);
+	}
+}
+
+template<unsigned N>
+void packedHypercube<N>::reduce(unsigned i)
+{
+	const unsigned w = i / 64, b = i % 64;
+	
+	induced[w] &= ~(word(1) << b);
+	--numInduced;
+	
+	decrement(w, localNeighbors[b]);
+	for (unsigned j = wordDims; j < N; j++)
+	{
+		decrement(w ^ (1 << (j - 6)), word(1) << b);
+	}
+}
+
+template<unsigned N>
+bool packedHypercube<N>::isInduced(unsigned i) const
+{
+	return (induced[i / 64] >> (i % 64)) & 1;
+}
+
+template<unsigned N>
+uint64_t packedHypercube<N>::extendableWord(unsigned w) const
+{
+	word result = degree[0][w] & ~induced[w];
+	for (unsigned k = 1; k < numPlanes; k++)
+	{
+		result &= ~degree[k][w];
+	}
+	return result;
+}
+
+template<unsigned N>
+bool packedHypercube<N>::extendable(unsigned i) const
+{
+	return (extendableWord(i / 64) >> (i % 64)) & 1;
+}
+
+template<unsigned N>
+uint64_t packedHypercube<N>::openWord(unsigned w) const
+{
+	word used = induced[w];
+	for (unsigned k = 0; k < numPlanes; k++)
+	{
+		used |= degree[k][w];
+	}
+	return ~used;
+}
+
+template<unsigned N>
+bool packedHypercube<N>::open(unsigned i) const
+{
+	return (openWord(i / 64) >> (i % 64)) & 1;
+}
+
+template<unsigned N>
+std::size_t packedHypercube<N>::hash() const
+{
+	std::size_t hash = 0;
+	
+	for (word w : induced)
+	{
+		// Multiplier from splitmix64, to spread the bits around.
+		hash = (hash ^ w) * 0x9e3779b97f4a7c15;
+	}
+	
+	return hash ^ (hash >> 32);
+}
+
+template<unsigned N>
+bool packedHypercube<N>::operator==(const packedHypercube& other) const
+{
+	return induced == other.induced;
+}
+
+template<unsigned N>
+std::ostream& operator<<(std::ostream& stream, const packedHypercube<N>& h)
+{
+	for (unsigned i = 0; i < h.numVertices; i++)
+	{
+		stream << (h.isInduced(i) ? "X " : "_ ");
+	}
+	return stream << "| " << h.numInduced << " vertices";
+}
@@ -1,38 +1,109 @@
 #ifndef PERMUTATION_HPP
 #define PERMUTATION_HPP
 
-// Permutations of N-dimensional hypercube.
-// The permutations cannot be assumed to be
-// in any specific order, and may change
-// in future versions.
+#include <bit>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <iterator>
+#include <algorithm>
 
-// Before accessing a permutation set,
-// you should first call permutationSet<X>::init()
-// for only the largest value of X that is needed,
-// any smaller values are also filled in.
+// Symmetries of the N-dimensional hypercube.
 
-// Known issue: This does not compile for N >= 8
-// and with -O3 due to stack size issues.
+// Every symmetry is a permutation of the axes followed by flipping
+// some of them, so it only needs N + 1 small numbers to store, rather
+// than a table of every vertex. There are N! * 2^N of them, so at N = 8
+// a full table of tables would be about 10 GB (which is why this used
+// to not compile for N >= 8).
 
 template<unsigned N>
-struct permutationSet
+struct symmetry
 {
+	// A symmetry applied to every vertex, [i] is where vertex i goes.
 	typedef std::array<unsigned,(1 << N)> permutation;
 	
-	static inline std::array<permutation,
-		permutationSet<N-1>::perms.size()*2*N> perms = {};
+	// Bit i of a vertex moves to bit axes[i], then the result is XORed with mask.
+	std::array<unsigned char,N> axes;
+	unsigned mask;
 	
-	static void init();
+	// The identity.
+	symmetry();
+	
+	// Where vertex v goes, in O(N).
+	unsigned operator()(unsigned v) const;
+	
+	// Where every vertex goes, in O(2^N).
+	permutation vertexMap() const;
+	
+	// A set of vertices, vertex v is bit v % 64 of word v / 64.
+	typedef std::array<uint64_t,(1 << N) < 64 ? 1 : (1 << N) / 64> vertexMask;
+	
+	// The set of g(v) for every v in the set, and the set of every v with
+	// g(v) in the set. These move whole words at a time: at most N - 1 swaps
+	// of two axes, then a flip for each bit of the mask, each a few shifts
+	// by masks from a table. This beats going through the vertex map once
+	// there are more than a handful of vertices.
+	vertexMask image(const vertexMask& vertices) const;
+	vertexMask preimage(const vertexMask& vertices) const;
+	
+	private:
+	
+	// Bit i of every vertex moves to bit to[i].
+	static void moveAxes(vertexMask& vertices, const std::array<unsigned char,N>& to);
+	
+	static void swapAxes(vertexMask& vertices, unsigned i, unsigned j);
+	static void flipAxis(vertexMask& vertices, unsigned i);
 };
 
-template<>
-struct permutationSet<0>
+// The set of all symmetries, generated lazily. Iterating over this gives
+// the vertex map of each symmetry in turn, and never stores more than one.
+// The order is by axis permutation (lexicographically), then by mask, but
+// shouldn't be relied on.
+template<unsigned N>
+struct symmetryGroup
 {
-	typedef std::array<unsigned,1> permutation;
+	typedef typename symmetry<N>::permutation permutation;
 	
-	static inline std::array<permutation,1> perms = {};
-
-	static void init();
+	// N! * 2^N
+	constexpr static std::size_t size();
+	
+	class iterator
+	{
+		symmetry<N> current;
+		
+		// Where each vertex goes with just the axis permutation, the mask is
+		// XORed in after. Only needs to be redone when the axes change,
+		// which is every 2^N steps.
+		permutation axisMap;
+		permutation vertexMap;
+		bool done;
+		
+		void updateAxisMap();
+		
+		public:
+		
+		typedef std::ptrdiff_t difference_type;
+		typedef permutation value_type;
+		
+		iterator();
+		
+		const permutation& operator*() const { return vertexMap; }
+		const symmetry<N>& get() const { return current; }
+		
+		iterator& operator++();
+		void operator++(int) { ++*this; }
+		
+		bool operator==(std::default_sentinel_t) const { return done; }
+	};
+	
+	iterator begin() const { return iterator(); }
+	std::default_sentinel_t end() const { return {}; }
+	
+	// Calls f with every symmetry, in the same order as iterating,
+	// but without building any vertex maps.
+	template<class F>
+	static void forEach(F&& f);
 };
 
 #include "permutation.tpp"
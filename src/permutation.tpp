@@ -1,64 +1,268 @@
 #include "permutation.hpp"
 
 template<unsigned N>
-void permutationSet<N>::init()
+symmetry<N>::symmetry() : mask(0)
 {
-	permutationSet<N-1>::init();
-	
-	unsigned index = 0;
-	for (const auto& subPerm : permutationSet<N-1>::perms)
-	{
-		// This dimension is going to represent where the interleaving
-		// occurs. Examples: (on 1234)
-		// For i = 0, this would change every 2^0 = 1 times,
-		// so this would be 15263748.
-		// For i = 1, this would change every 2^1 = 2 times,
-		// so this would be 12563478.
-		// For i = 2, this would change every 2^2 = 4 times,
-		// so this would be 12345678.
-		// Then there is another version that is reversed,
-		// for these three would be 51627384, 56218743, and 56781234.
-		for (unsigned i = 0; i < N; i++)
+	for (unsigned i = 0; i < N; i++)
+	{
+		axes[i] = i;
+	}
+}
+
+template<unsigned N>
+unsigned symmetry<N>::operator()(unsigned v) const
+{
+	unsigned result = 0;
+	for (unsigned i = 0; i < N; i++)
+	{
+		result |= ((v >> i) & 1) << axes[i];
+	}
+	return result ^ mask;
+}
+
+template<unsigned N>
+typename symmetry<N>::permutation symmetry<N>::vertexMap() const
+{
+	permutation result;
+	
+	// Permuting the axes is linear (over XOR), so each vertex is
+	// a smaller vertex with its lowest bit moved. The mask is
+	// left out until the end.
+	result[0] = 0;
+	for (unsigned v = 1; v < result.size(); v++)
+	{
+		result[v] = result[v & (v - 1)] | (1u << axes[std::countr_zero(v)]);
+	}
+	
+	for (auto& image : result)
+	{
+		image ^= mask;
+	}
+	
+	return result;
+}
+
+// The masks the word operations shift by, for the axes within a word.
+// Vertices past 2^N are left out, so they stay clear for N < 6.
+template<unsigned N>
+struct axisMasks
+{
+	constexpr static unsigned bits = (1 << N) < 64 ? (1 << N) : 64;
+	
+	// [i] has the bits whose vertex has bit i set.
+	std::array<uint64_t,6> high{};
+	
+	// [i][j] has the bits whose vertex has bit i set and bit j clear.
+	std::array<std::array<uint64_t,6>,6> highLow{};
+	
+	constexpr axisMasks()
+	{
+		for (unsigned b = 0; b < bits; b++)
 		{
-			unsigned ind = 0;
-			unsigned subind1 = 0, subind2 = 0;
-			while (ind < perms[0].size())
+			for (unsigned i = 0; i < 6; i++)
 			{
-				for (unsigned j = 0; j < (1u << i); j++)
-				{
-					perms[index][ind++] = subPerm[subind1++];
-				}
-				for (unsigned j = 0; j < (1u << i); j++)
+				if (!(b & (1 << i))) continue;
+				
+				high[i] |= uint64_t(1) << b;
+				for (unsigned j = 0; j < 6; j++)
 				{
-					perms[index][ind++] = subPerm.size() + subPerm[subind2++];
-				}
-			}
-			
-			++index;
-			
-			// Do the same thing, but swap the groups. This
-			// could probably be cleaner without code duplication.
-			
-			ind = 0;
-			subind1 = 0, subind2 = 0;
-			while (ind < perms[0].size())
-			{
-				for (unsigned j = 0; j < (1u << i); j++)
-				{
-					perms[index][ind++] = subPerm.size() + subPerm[subind1++];
-				}
-				for (unsigned j = 0; j < (1u << i); j++)
-				{
-					perms[index][ind++] = subPerm[subind2++];
+					if (!(b & (1 << j))) highLow[i][j] |= uint64_t(1) << b;
 				}
 			}
+		}
+	}
+};
+
+template<unsigned N>
+constexpr axisMasks<N> axisMaskTable;
+
+template<unsigned N>
+typename symmetry<N>::vertexMask symmetry<N>::image(const vertexMask& vertices) const
+{
+	vertexMask result = vertices;
+	moveAxes(result, axes);
+	
+	for (unsigned i = 0; i < N; i++)
+	{
+		if (mask & (1 << i)) flipAxis(result, i);
+	}
+	
+	return result;
+}
+
+template<unsigned N>
+typename symmetry<N>::vertexMask symmetry<N>::preimage(const vertexMask& vertices) const
+{
+	// g^-1(v) is the mask flipped first, then the axes moved back.
+	vertexMask result = vertices;
+	
+	for (unsigned i = 0; i < N; i++)
+	{
+		if (mask & (1 << i)) flipAxis(result, i);
+	}
+	
+	std::array<unsigned char,N> back;
+	for (unsigned i = 0; i < N; i++)
+	{
+		back[axes[i]] = i;
+	}
+	moveAxes(result, back);
+	
+	return result;
+}
+
+template<unsigned N>
+void symmetry<N>::moveAxes(vertexMask& vertices, const std::array<unsigned char,N>& to)
+{
+	// [p] is the axis that is at bit p at the moment. Each step puts the
+	// right axis at bit p, and never touches the bits before it again.
+	std::array<unsigned char,N> at;
+	for (unsigned p = 0; p < N; p++)
+	{
+		at[p] = p;
+	}
+	
+	for (unsigned p = 0; p < N; p++)
+	{
+		unsigned q = p;
+		while (to[at[q]] != p) q++;
+		
+		if (q != p)
+		{
+			swapAxes(vertices, p, q);
+			std::swap(at[p], at[q]);
+		}
+	}
+}
+
+template<unsigned N>
+void symmetry<N>::swapAxes(vertexMask& vertices, unsigned i, unsigned j)
+{
+	// i < j. The vertices with bit i set and bit j clear trade places with
+	// the ones that are the other way around, the rest stay put.
+	const auto& table = axisMaskTable<N>;
+	
+	if (j < 6)
+	{
+		const unsigned shift = (1 << j) - (1 << i);
+		const uint64_t m = table.highLow[i][j];
+		
+		for (auto& w : vertices)
+		{
+			const uint64_t t = (w ^ (w >> shift)) & m;
+			w ^= t ^ (t << shift);
+		}
+	}
+	else if (i < 6)
+	{
+		// Bit j picks the word, so the pairs are in different words.
+		const unsigned shift = 1 << i;
+		const unsigned jWord = 1 << (j - 6);
+		const uint64_t m = table.high[i];
+		
+		for (unsigned w = 0; w < vertices.size(); w++)
+		{
+			if (w & jWord) continue;
 			
-			++index;
+			const uint64_t t = (vertices[w] ^ (vertices[w | jWord] << shift)) & m;
+			vertices[w] ^= t;
+			vertices[w | jWord] ^= t >> shift;
+		}
+	}
+	else
+	{
+		const unsigned iWord = 1 << (i - 6), jWord = 1 << (j - 6);
+		
+		for (unsigned w = 0; w < vertices.size(); w++)
+		{
+			if ((w & iWord) && !(w & jWord)) std::swap(vertices[w], vertices[w ^ iWord ^ jWord]);
 		}
 	}
 }
 
-void permutationSet<0>::init()
+template<unsigned N>
+void symmetry<N>::flipAxis(vertexMask& vertices, unsigned i)
 {
-	perms = {{0}};
+	if (i < 6)
+	{
+		const unsigned shift = 1 << i;
+		const uint64_t m = axisMaskTable<N>.high[i];
+		
+		for (auto& w : vertices)
+		{
+			w = ((w & m) >> shift) | ((w << shift) & m);
+		}
+	}
+	else
+	{
+		const unsigned iWord = 1 << (i - 6);
+		
+		for (unsigned w = 0; w < vertices.size(); w++)
+		{
+			if (w & iWord) std::swap(vertices[w], vertices[w ^ iWord]);
+		}
+	}
+}
+
+template<unsigned N>
+constexpr std::size_t symmetryGroup<N>::size()
+{
+	std::size_t result = 1 << N;
+	for (unsigned i = 2; i <= N; i++)
+	{
+		result *= i;
+	}
+	return result;
+}
+
+template<unsigned N>
+symmetryGroup<N>::iterator::iterator() : done(false)
+{
+	updateAxisMap();
+	vertexMap = axisMap;
+}
+
+template<unsigned N>
+void symmetryGroup<N>::iterator::updateAxisMap()
+{
+	current.mask = 0;
+	axisMap = current.vertexMap();
+}
+
+template<unsigned N>
+typename symmetryGroup<N>::iterator& symmetryGroup<N>::iterator::operator++()
+{
+	// Go through every mask, then move on to the next axis permutation.
+	if (++current.mask == (1u << N))
+	{
+		if (!std::next_permutation(current.axes.begin(), current.axes.end()))
+		{
+			done = true;
+			return *this;
+		}
+		updateAxisMap();
+	}
+	
+	for (unsigned i = 0; i < vertexMap.size(); i++)
+	{
+		vertexMap[i] = axisMap[i] ^ current.mask;
+	}
+	
+	return *this;
+}
+
+template<unsigned N>
+template<class F>
+void symmetryGroup<N>::forEach(F&& f)
+{
+	symmetry<N> current;
+	
+	do
+	{
+		for (current.mask = 0; current.mask < (1u << N); current.mask++)
+		{
+			f(std::as_const(current));
+		}
+	}
+	while (std::next_permutation(current.axes.begin(), current.axes.end()));
 }
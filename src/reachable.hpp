@@ -0,0 +1,34 @@
+#ifndef REACHABLE_HPP
+#define REACHABLE_HPP
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include "hypercube.hpp"
+#include "packedHypercube.hpp"
+
+// A set of vertices of the N-cube, with vertex i as bit (i % 64) of
+// word (i / 64), the same layout packedHypercube uses. For N < 6 only
+// the low 2^N bits of the one word are used.
+template<unsigned N>
+using vertexWords = std::array<uint64_t, N < 6 ? 1 : (1 << (N - 6))>;
+
+// The vertices a snake ending at 'from' could still grow into: the
+// extendable neighbors of 'from', and every open vertex connected to
+// them through other open vertices. (The complement of this is the
+// footprint in count-forms.)
+
+// Rather than a DFS one vertex at a time, this keeps the region and the
+// vertices added last as bitmasks, and grows them by all neighbors of
+// the last ones at once, across every dimension. Moving across a
+// dimension below 6 is a shift within each word, and across one above
+// is swapping words. Nothing is allocated.
+template<class cube>
+vertexWords<cube::dimension> reachableRegion(const cube& h, unsigned from);
+
+template<unsigned N>
+std::bitset<(1 << N)> toBitset(const vertexWords<N>& words);
+
+#include "reachable.tpp"
+
+#endif
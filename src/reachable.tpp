@@ -0,0 +1,105 @@
+#include "reachable.hpp"
+
+// The open vertices of h, as words.
+template<unsigned N>
+vertexWords<N> openVertices(const hypercube<N>& h)
+{
+	vertexWords<N> result {};
+	for (unsigned i = 0; i < hypercube<N>::numVertices; ++i)
+	{
+		if (h.open(i)) result[i / 64] |= uint64_t(1) << (i % 64);
+	}
+	return result;
+}
+
+template<unsigned N>
+vertexWords<N> openVertices(const packedHypercube<N>& h)
+{
+	vertexWords<N> result;
+	for (unsigned w = 0; w < result.size(); ++w)
+	{
+		result[w] = h.openWord(w);
+	}
+	
+	// Cut off the bits past the last vertex.
+	if constexpr (N < 6) result[0] &= (uint64_t(1) << (1 << N)) - 1;
+	
+	return result;
+}
+
+template<class cube>
+vertexWords<cube::dimension> reachableRegion(const cube& h, unsigned from)
+{
+	constexpr unsigned N = cube::dimension;
+	constexpr unsigned wordDims = N < 6 ? N : 6;
+	constexpr unsigned numWords = std::tuple_size_v<vertexWords<N>>;
+	
+	// [j] is the set of bits in a word whose index doesn't have bit j,
+	// so moving them across dimension j is a left shift by 2^j.
+	constexpr uint64_t lower[] =
+	{
+		0x5555555555555555, 0x3333333333333333, 0x0F0F0F0F0F0F0F0F,
+		0x00FF00FF00FF00FF, 0x0000FFFF0000FFFF, 0x00000000FFFFFFFF
+	};
+	
+	const vertexWords<N> open = openVertices(h);
+	
+	vertexWords<N> region {};
+	for (unsigned adj : cube::adjLists[from])
+	{
+		if (h.extendable(adj)) region[adj / 64] |= uint64_t(1) << (adj % 64);
+	}
+	
+	// Vertices that were just added, whose neighbors haven't been looked at.
+	vertexWords<N> frontier = region;
+	bool grew = true;
+	
+	while (grew)
+	{
+		vertexWords<N> next;
+		for (unsigned w = 0; w < numWords; ++w)
+		{
+			uint64_t neighbors = 0;
+			for (unsigned j = 0; j < wordDims; ++j)
+			{
+				const unsigned shift = 1 << j;
+				neighbors |= ((frontier[w] & lower[j]) << shift)
+				           | ((frontier[w] >> shift) & lower[j]);
+			}
+			for (unsigned j = wordDims; j < N; ++j)
+			{
+				neighbors |= frontier[w ^ (1 << (j - 6))];
+			}
+			next[w] = neighbors & open[w] & ~region[w];
+		}
+		
+		grew = false;
+		for (unsigned w = 0; w < numWords; ++w)
+		{
+			region[w] |= next[w];
+			grew |= next[w] != 0;
+		}
+		frontier = next;
+	}
+	
+	return region;
+}
+
+template<unsigned N>
+std::bitset<(1 << N)> toBitset(const vertexWords<N>& words)
+{
+	if constexpr (N <= 6)
+	{
+		return std::bitset<(1 << N)>(words[0]);
+	}
+	else
+	{
+		std::bitset<(1 << N)> result;
+		for (unsigned w = words.size(); w-- > 0;)
+		{
+			result <<= 64;
+			result |= std::bitset<(1 << N)>(words[w]);
+		}
+		return result;
+	}
+}
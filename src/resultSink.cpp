@@ -0,0 +1,72 @@
+#include <stdexcept>
+#include "resultSink.hpp"
+
+resultSink::resultSink(const options& opts, unsigned dimension) :
+	numVertices(1 << dimension), stream(&std::cout), results(0)
+{
+	const std::string name = opts.getString("output", "text");
+	
+	if (name == "text") fmt = text;
+	else if (name == "binary") fmt = binary;
+	else if (name == "count") fmt = count;
+	else throw std::runtime_error("unknown output format " + name);
+	
+	const std::string path = opts.getString("out", "");
+	
+	// Everything else the programs print would end up in the middle of it.
+	if (fmt == binary && path.empty())
+	{
+		throw std::runtime_error("binary output requires --out=FILE");
+	}
+	
+	if (!path.empty())
+	{
+		// The buffer has to be set before the file is opened.
+		fileBuffer.resize(1 << 20);
+		file = std::make_unique<std::ofstream>();
+		file->rdbuf()->pubsetbuf(fileBuffer.data(), fileBuffer.size());
+		file->open(path, fmt == binary ? std::ios::binary : std::ios::out);
+		
+		if (!*file)
+		{
+			throw std::runtime_error("could not open " + path);
+		}
+		
+		stream = file.get();
+	}
+	
+	if (fmt == binary)
+	{
+		record.resize(3 * sizeof(uint32_t) + (numVertices + 7) / 8);
+		
+		const uint32_t header[3] = { 1, dimension, (uint32_t)record.size() };
+		
+		stream->write("SIAB", 4);
+		stream->write(reinterpret_cast<const char*>(header), sizeof(header));
+	}
+}
+
+resultSink::~resultSink()
+{
+	if (fmt == count)
+	{
+		*stream << results << " results" << std::endl;
+	}
+	
+	stream->flush();
+}
+
+void resultSink::comment(const std::string& line)
+{
+	if (fmt == text) *stream << line << '\n';
+}
+
+void resultSink::flush()
+{
+	stream->flush();
+}
+
+unsigned long long resultSink::numResults() const
+{
+	return results;
+}
@@ -0,0 +1,76 @@
+#ifndef RESULT_SINK_HPP
+#define RESULT_SINK_HPP
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include "options.hpp"
+
+// Where the programs send the snakes (and subcubes) they find. Chosen with
+// --output=FORMAT, and written to --out=FILE, or standard output if there
+// is no file (except for binary, which always needs a file). The formats are:
+//
+// text:   What the programs have always printed, one result per line, but
+//         buffered rather than flushed after every line.
+// binary: A header of "SIAB", then the version (1), the dimension and the
+//         size of a record, each as a 32 bit integer. Each record is the
+//         group, the two endpoints (0xFFFFFFFF if there aren't any) as 32
+//         bit integers, then the induced vertices, with vertex v being bit
+//         v % 8 of byte v / 8. Integers are in the machine's byte order.
+// count:  Nothing but the number of results, once everything is done.
+class resultSink
+{
+	public:
+	
+	enum format { text, binary, count };
+	
+	constexpr static uint32_t none = 0xFFFFFFFF;
+	
+	// Throws std::runtime_error if the format is unknown or
+	// the file can't be opened.
+	resultSink(const options& opts, unsigned dimension);
+	
+	// Flushes everything, and prints the count in count mode.
+	~resultSink();
+	
+	resultSink(const resultSink&) = delete;
+	resultSink& operator=(const resultSink&) = delete;
+	
+	// Records one result. induced(v) should say if vertex v is in it. The
+	// group is up to the program, like the size of a snake in siab4. Text
+	// mode prints the result with operator<<, and ignores everything else.
+	template<class T, class F>
+	void write(const T& result, F&& induced, uint32_t group = 0,
+		std::array<uint32_t,2> endpoints = { none, none });
+	
+	// A line that only goes in text output, like a heading.
+	void comment(const std::string&);
+	
+	// Makes sure everything written so far has shown up, for programs
+	// that report results as they go.
+	void flush();
+	
+	unsigned long long numResults() const;
+	
+	private:
+	
+	format fmt;
+	unsigned numVertices;
+	
+	std::unique_ptr<std::ofstream> file;
+	std::ostream* stream;
+	
+	// Buffer for the file, and a record for binary mode.
+	std::vector<char> fileBuffer;
+	std::vector<char> record;
+	
+	unsigned long long results;
+};
+
+#include "resultSink.tpp"
+
+#endif
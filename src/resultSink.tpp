@@ -0,0 +1,28 @@
+#include <cstring>
+
+template<class T, class F>
+void resultSink::write(const T& result, F&& induced, uint32_t group,
+	std::array<uint32_t,2> endpoints)
+{
+	++results;
+	
+	if (fmt == text)
+	{
+		*stream << result << '\n';
+	}
+	else if (fmt == binary)
+	{
+		const uint32_t header[3] = { group, endpoints[0], endpoints[1] };
+		std::memcpy(record.data(), header, sizeof(header));
+		
+		char* bits = record.data() + sizeof(header);
+		std::fill(bits, record.data() + record.size(), 0);
+		
+		for (unsigned v = 0; v < numVertices; v++)
+		{
+			if (induced(v)) bits[v / 8] |= 1 << (v % 8);
+		}
+		
+		stream->write(record.data(), record.size());
+	}
+}
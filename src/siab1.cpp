@@ -5,26 +5,37 @@ performs. Inputs 1-5 finish essentially instantly, 6 finishes in about
 */
 
 #include <iostream>
+#include "options.hpp"
 #include "hypercube.hpp"
+#include "dimension.hpp"
+#include "packedHypercube.hpp"
+#include "resultSink.hpp"
 
-// A macro named "MAX_DIM" will be compiled in.
+// The dimension is given with --dim=N, and the hypercube representation
+// is a template parameter, so either hypercube or packedHypercube can be
+// used (selected with --packed).
+
+// Where each new best snake goes, set up in main.
+resultSink* results = nullptr;
 
 // Does a naive depth-first search for the largest induced path
-void enumerate(hypercube<MAX_DIM>& h, unsigned lastAddition)
+template<class cube>
+void enumerate(cube& h, unsigned lastAddition)
 {
 	static unsigned maxNumInduced = 0;
 	
 	if (h.numInduced > maxNumInduced)
 	{
 		maxNumInduced = h.numInduced;
-		std::cout << h;
+		results->write(h, [&](unsigned v) { return h.isInduced(v); }, h.numInduced);
+		results->flush();
 	}
-
-	for (unsigned adj : hypercube<MAX_DIM>::adjLists[lastAddition])
+	
+	for (unsigned adj : cube::adjLists[lastAddition])
 	{
 		// We need to check that the neighbor isn't induced specifically
 		// for the case of the starting vertex's first expansion.
-		if (h.vertices[adj].effectiveDegree == 1 && !h.vertices[adj].induced)
+		if (h.extendable(adj))
 		{
 			h.induce(adj);
 			enumerate(h,adj);
@@ -33,11 +44,50 @@ void enumerate(hypercube<MAX_DIM>& h, unsigned lastAddition)
 	}
 }
 
-int main()
+template<class cube>
+void run()
 {
-	hypercube<MAX_DIM> h;
+	cube h;
 	
 	h.induce(0);
-
+	
 	enumerate(h,0);
 }
+
+int main(int argn, char** args)
+{
+	options opts(argn, args);
+	
+	if (auto flag = opts.unknown({"dim", "packed", "output", "out"}); !flag.empty())
+	{
+		std::cerr << "Error: unknown flag --" << flag << std::endl;
+		return 1;
+	}
+	
+	const unsigned dim = opts.get("dim", 0);
+	
+	if (dim < 1 || dim > 8)
+	{
+		std::cerr << "Error: requires --dim=N, for N from 1 to 8" << std::endl;
+		return 1;
+	}
+	
+	try
+	{
+		resultSink sink(opts, dim);
+		results = &sink;
+		
+		withDimension<1, 8>(dim, [&]<unsigned N>()
+		{
+			if (opts.has("packed"))
+				run<packedHypercube<N>>();
+			else
+				run<hypercube<N>>();
+		});
+	}
+	catch (std::runtime_error& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+}
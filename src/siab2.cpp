@@ -6,49 +6,870 @@ At each step, we keep track of the largest dimension used. We are only allowed t
 move in a given dimension after moving in all previous ones at least once.
 
 This is a bit better, d=6 finishes almost instantly, but is unable to finish 7.
+
+With --threads=T, the search tree is split into subtrees at a depth of
+--split=D vertices, and the subtrees are searched on T threads. Only the
+final answer is printed in that case, which is the same snake the
+single threaded search would end on.
+
+With --bound, branches are cut when an upper bound on the size of any
+snake in them can't beat the best found so far.
+
+With --checkpoint=FILE, the search is saved to FILE every --interval=S
+seconds (default 600), and --resume continues from it. A single threaded
+checkpoint is the path to the current node, a multithreaded one is the
+list of tasks left to do.
+
+With --symmetry, the single threaded search also counts how many classes
+of snakes it visits, up to the symmetries of the hypercube and reversal.
+Starting at vertex 0 already picks one reflection for each direction of a
+snake, and the dimension rule picks one axis permutation, so every node is
+a different snake traversed in one direction, and the only symmetry left
+is the node for the same snake traversed the other way. Which of the two is
+counted can only be told once the whole snake is known, so this doesn't cut
+any branches: a subtree under a node that isn't counted still holds nodes
+that are. --symmetry=check also canonicalizes every node's vertex set, to
+make sure each class is counted exactly once.
+
+The search can also look for other kinds of paths, with the same threads,
+bound and checkpoints: --coil looks for the largest coil (induced cycle),
+and --spread=K for the largest snake of spread K, where vertices i and j of
+the path are at least min(|i - j|, K) apart. Spread 2 is a plain snake.
 */
 
+#include <array>
+#include <bit>
+#include <atomic>
+#include <bitset>
+#include <vector>
+#include <mutex>
 #include <iostream>
+#include <filesystem>
+#include <unordered_set>
+#include "options.hpp"
+#include "workPool.hpp"
+#include "checkpoint.hpp"
 #include "hypercube.hpp"
+#include "dimension.hpp"
+#include "packedHypercube.hpp"
+#include "resultSink.hpp"
+#include "reachable.hpp"
+#include "canonical.hpp"
+
+// The dimension is given with --dim=N, and the hypercube representation
+// is a template parameter, so either hypercube or packedHypercube can be
+// used (selected with --packed).
+
+// Largest snakes (in vertices) for each dimension, as far as they are
+// proven. The bound caps branches with these, so an entry that is only the
+// best known could cut a longer snake. The best known for 8 is 99, but it
+// isn't proven, so 8 doesn't get a cap.
+constexpr unsigned knownMaxima[] = { 1, 2, 3, 5, 8, 14, 27, 51 };
+
+// Set by --bound.
+bool useBound = false;
+
+// Set by --symmetry and --symmetry=check.
+bool countClasses = false;
+bool checkClasses = false;
+
+struct counters
+{
+	unsigned long long nodes = 0;
+	unsigned long long pruned = 0;
+};
+
+// Upper bound on the number of vertices of any snake in the subtree
+// ending at lastAddition.
+// The snake can only grow into vertices reachable from an extendable
+// neighbor of lastAddition through open vertices (the footprint from
+// count-forms). Since vertices alternate parity along the snake, it
+// can't use more than one more vertex of the opposite parity than
+// of the same parity as lastAddition.
+template<class cube>
+unsigned upperBound(const cube& h, unsigned lastAddition)
+{
+	const auto region = reachableRegion(h, lastAddition);
+	
+	// Bit i of oddBits is set if i has an odd number of bits. Word w holds
+	// vertices 64w to 64w + 63, so its parities are flipped if w is odd.
+	constexpr uint64_t oddBits = 0x6996966996696996;
+	
+	// [0] is the same parity as lastAddition, [1] is the opposite.
+	std::array<unsigned, 2> count = { 0, 0 };
+	const unsigned parity = std::popcount(lastAddition) & 1;
+	
+	for (unsigned w = 0; w < region.size(); ++w)
+	{
+		const uint64_t odd = (std::popcount(w) & 1) ? ~oddBits : oddBits;
+		const unsigned numOdd = std::popcount(region[w] & odd);
+		const unsigned numEven = std::popcount(region[w]) - numOdd;
+		
+		count[parity == 0] += numOdd;
+		count[parity == 1] += numEven;
+	}
+	
+	unsigned growth = count[1] > count[0] ? 2 * count[0] + 1 : 2 * count[1];
+	
+	if constexpr (cube::dimension < std::size(knownMaxima))
+		return std::min(h.numInduced + growth, knownMaxima[cube::dimension]);
+	else
+		return h.numInduced + growth;
+}
+
+// The rules for which paths the search looks for. They are told about
+// every vertex added to the path (after the cube is) and removed from it
+// (before the cube is), and decide which vertices can be added next, which
+// paths are results, and how large a result below a path could be. The
+// search is templated on them, so the snake rules compile down to the
+// same code as before there were any.
+
+// Snakes: every induced path is a result.
+template<class cube>
+struct snakeRules
+{
+	// Added to the checkpoint program numbers, so that a checkpoint can't
+	// be resumed with different rules.
+	uint32_t variant() const { return 0; }
+	
+	void induce(const cube&, unsigned) {}
+	void reduce(const cube&, unsigned) {}
+	
+	bool canExtend(const cube& h, unsigned, unsigned adj) const { return h.extendable(adj); }
+	
+	bool isResult(const cube&, unsigned) const { return true; }
+	bool canGrow(const cube&, unsigned) const { return true; }
+	
+	unsigned upperBound(const cube& h, unsigned lastAddition) const
+	{
+		return ::upperBound(h, lastAddition);
+	}
+};
+
+// Coils: induced cycles through vertex 0. The path is closed by a vertex
+// next to its end and to vertex 0, and nothing else on the path. Only
+// closed paths are results, and they can't grow any further.
+template<class cube>
+struct coilRules
+{
+	uint32_t variant() const { return 1; }
+	
+	void induce(const cube&, unsigned) {}
+	void reduce(const cube&, unsigned) {}
+	
+	bool canExtend(const cube& h, unsigned, unsigned adj) const
+	{
+		if (h.extendable(adj)) return true;
+		
+		if (h.numInduced < 3 || std::popcount(adj) != 1 || h.isInduced(adj)) return false;
+		
+		// adj is next to the end and to vertex 0, so it closes the cycle
+		// if those are its only neighbors on the path.
+		unsigned induced = 0;
+		for (unsigned v : cube::adjLists[adj])
+		{
+			induced += h.isInduced(v);
+		}
+		return induced == 2;
+	}
+	
+	// Only the vertex closing the cycle can be next to vertex 0, other
+	// than the second one.
+	bool isResult(const cube& h, unsigned lastAddition) const
+	{
+		return h.numInduced > 2 && std::popcount(lastAddition) == 1;
+	}
+	
+	bool canGrow(const cube& h, unsigned lastAddition) const
+	{
+		return !isResult(h, lastAddition);
+	}
+	
+	// Without the vertex that closes it, a coil is a snake.
+	unsigned upperBound(const cube& h, unsigned lastAddition) const
+	{
+		return ::upperBound(h, lastAddition) + 1;
+	}
+};
+
+// Snakes of spread k. Every vertex counts how many vertices of the path are
+// less than k away from it. A vertex can be added if the only ones are the
+// last k - 1 on the path, and they are as far away as they are along the
+// path, which is the case if the last k - 1 moves and this one are all in
+// different dimensions.
+template<class cube>
+struct spreadRules
+{
+	unsigned k;
+	
+	// Every set of dimensions with fewer than k in it, as a mask.
+	std::vector<unsigned> ball;
+	
+	// [v] is the number of vertices of the path less than k away from v.
+	std::array<uint16_t, cube::numVertices> near {};
+	
+	std::array<unsigned, cube::numVertices> path;
+	unsigned length = 0;
+	
+	spreadRules(unsigned spread) : k(spread)
+	{
+		for (unsigned mask = 0; mask < cube::numVertices; mask++)
+		{
+			if ((unsigned)std::popcount(mask) < k) ball.push_back(mask);
+		}
+	}
+	
+	uint32_t variant() const { return k; }
+	
+	void induce(const cube&, unsigned v)
+	{
+		for (unsigned mask : ball) ++near[v ^ mask];
+		path[length++] = v;
+	}
+	
+	void reduce(const cube&, unsigned v)
+	{
+		for (unsigned mask : ball) --near[v ^ mask];
+		--length;
+	}
+	
+	bool canExtend(const cube& h, unsigned lastAddition, unsigned adj) const
+	{
+		if (h.isInduced(adj)) return false;
+		
+		const unsigned recent = std::min(length, k - 1);
+		const unsigned move = adj ^ lastAddition;
+		
+		for (unsigned i = length - recent + 1; i < length; i++)
+		{
+			if ((path[i] ^ path[i - 1]) == move) return false;
+		}
+		
+		return near[adj] == recent;
+	}
+	
+	bool isResult(const cube&, unsigned) const { return true; }
+	bool canGrow(const cube&, unsigned) const { return true; }
+	
+	// A snake of spread k is also a snake.
+	unsigned upperBound(const cube& h, unsigned lastAddition) const
+	{
+		return ::upperBound(h, lastAddition);
+	}
+};
+
+// Program numbers for checkpoint files. The variant of the rules is
+// added on top, shifted up by 8.
+constexpr uint32_t sequentialCheckpoint = 0x20;
+constexpr uint32_t parallelCheckpoint = 0x21;
+
+// Set by --checkpoint, --interval and --resume. The checkpoint file is
+// empty if checkpointing is off.
+std::string checkpointFile;
+unsigned checkpointInterval = 600;
+bool resume = false;
+
+// Where each new best snake goes, set up in main.
+resultSink* sink = nullptr;
+
+// Snakes are grouped by their number of vertices.
+template<class cube>
+void report(const cube& h)
+{
+	sink->write(h, [&](unsigned v) { return h.isInduced(v); }, h.numInduced);
+	sink->flush();
+}
+
+// State of the single threaded search.
+template<class cube>
+struct searchState
+{
+	cube best;
+	counters stats;
+	
+	// [i] is the vertex at depth i of the current path.
+	std::array<unsigned, cube::numVertices> path;
+	
+	// When resuming, the path to the node the checkpoint was taken at.
+	std::vector<unsigned> resumePath;
+	bool resuming = false;
+	
+	checkpointTimer timer = checkpointInterval;
+	
+	// With --symmetry, the number of nodes counted as classes. With
+	// --symmetry=check, the canonical forms of the counted nodes, how many
+	// of those were already there, and the forms of every node.
+	unsigned long long classes = 0;
+	unsigned long long duplicates = 0;
+	std::unordered_set<std::bitset<cube::numVertices>> countedForms;
+	std::unordered_set<std::bitset<cube::numVertices>> allForms;
+};
+
+// Whether the snake along the first n vertices of 'path' is the direction
+// of it that --symmetry counts. Its reverse, moved to start at vertex 0 and
+// with its dimensions renamed in order of first use, is the node for the
+// other direction. The one with the smaller sequence of dimensions is
+// counted, and if they're the same, they're the same node.
+template<class cube>
+bool countedDirection(const std::array<unsigned, cube::numVertices>& path, unsigned n)
+{
+	// [d] is what dimension d of the reverse is renamed to.
+	std::array<unsigned, cube::dimension> rename;
+	rename.fill(cube::dimension);
+	unsigned nextDim = 0;
+	
+	for (unsigned i = 1; i < n; i++)
+	{
+		unsigned forward = std::countr_zero(path[i] ^ path[i - 1]);
+		unsigned backward = std::countr_zero(path[n - i] ^ path[n - i - 1]);
+		
+		if (rename[backward] == cube::dimension) rename[backward] = nextDim++;
+		
+		if (rename[backward] != forward) return forward < rename[backward];
+	}
+	
+	return true;
+}
 
-// A macro named "MAX_DIM" will be compiled in.
+template<class cube>
+void countClass(const cube& h, searchState<cube>& state)
+{
+	const bool counted = countedDirection<cube>(state.path, h.numInduced);
+	state.classes += counted;
+	
+	if (!checkClasses) return;
+	
+	std::bitset<cube::numVertices> vertices;
+	for (unsigned v = 0; v < cube::numVertices; v++)
+	{
+		vertices[v] = h.isInduced(v);
+	}
+	
+	const auto form = canonicalizer<cube::dimension>::canonicalize(vertices).form;
+	
+	state.allForms.insert(form);
+	if (counted && !state.countedForms.insert(form).second) ++state.duplicates;
+}
+
+// Saves the path to the current node (which hasn't been searched yet),
+// the best snake and the counters.
+template<class cube, class rules>
+void saveCheckpoint(const searchState<cube>& state, const rules& r, unsigned depth)
+{
+	checkpointWriter writer(checkpointFile, sequentialCheckpoint + (r.variant() << 8), cube::dimension);
+	
+	writer.write(state.stats);
+	writer.writeCube(state.best);
+	writer.writeVector(std::vector<uint16_t>(state.path.begin(), state.path.begin() + depth));
+	
+	writer.commit();
+}
+
+// 'r' is a copy of the rules the search starts with.
+template<class cube, class rules>
+void loadCheckpoint(searchState<cube>& state, rules r)
+{
+	checkpointReader reader(checkpointFile, sequentialCheckpoint + (r.variant() << 8), cube::dimension);
+	
+	state.stats = reader.read<counters>();
+	state.best = reader.readCube<cube>();
+	
+	auto path = reader.readVector<uint16_t>();
+	state.resumePath.assign(path.begin(), path.end());
+	state.resuming = true;
+	
+	// Make sure the path is one the search would actually take, or
+	// resuming would never reach the end of it.
+	cube h;
+	unsigned highestDim = 0;
+	for (unsigned i = 0; i < path.size(); i++)
+	{
+		unsigned dim = std::countr_zero(i ? path[i] ^ path[i-1] : 1u);
+		
+		if (i ? path[i] >= cube::numVertices || std::popcount(unsigned(path[i] ^ path[i-1])) != 1
+		        || !r.canExtend(h, path[i-1], path[i])
+		        || !r.canGrow(h, path[i-1]) || dim > highestDim
+		      : path[i] != 0)
+		{
+			throw std::runtime_error("checkpoint " + checkpointFile + " has an invalid path");
+		}
+		
+		h.induce(path[i]);
+		r.induce(h, path[i]);
+		highestDim += i && dim == highestDim;
+	}
+}
 
 // Does a naive depth-first search for the largest induced pat
-void enumerate(hypercube<MAX_DIM>& h, unsigned lastAddition, unsigned highestDim = 0)
+template<class cube, class rules>
+void enumerate(cube& h, unsigned lastAddition, unsigned highestDim, searchState<cube>& state, rules& r)
 {
-	static unsigned maxNumInduced = 0;
+	state.path[h.numInduced - 1] = lastAddition;
+	
+	// When resuming, follow resumePath down to the node the checkpoint
+	// was taken at. Branches before the path were already searched, so
+	// they are skipped. That node and everything after it is searched
+	// as usual.
+	unsigned first = 0;
 	
-	if (h.numInduced > maxNumInduced)
+	if (state.resuming && h.numInduced < state.resumePath.size())
 	{
-		maxNumInduced = h.numInduced;
-		std::cout << h;
+		first = std::countr_zero(lastAddition ^ state.resumePath[h.numInduced]);
+	}
+	else
+	{
+		state.resuming = false;
+		
+		if (!checkpointFile.empty() && state.timer.due())
+		{
+			saveCheckpoint(state, r, h.numInduced);
+		}
+		
+		++state.stats.nodes;
+		
+		if (countClasses) countClass(h, state);
+		
+		if (r.isResult(h, lastAddition) && h.numInduced > state.best.numInduced)
+		{
+			state.best = h;
+			report(h);
+		}
+		
+		if (!r.canGrow(h, lastAddition)) return;
+		
+		if (useBound && r.upperBound(h, lastAddition) <= state.best.numInduced)
+		{
+			++state.stats.pruned;
+			return;
+		}
 	}
 	
 	// The index in the adjacency list is also the dimension number, so
 	// capping the index gives the same result as capping dimension.
-	unsigned stop = std::min((unsigned)MAX_DIM,highestDim + 1);
-	for (unsigned i = 0; i < stop; i++)
+	unsigned stop = std::min(cube::dimension,highestDim + 1);
+	for (unsigned i = first; i < stop; i++)
 	{
-		unsigned adj = hypercube<MAX_DIM>::adjLists[lastAddition][i];
+		unsigned adj = cube::adjLists[lastAddition][i];
 		
 		// We need to check that the neighbor isn't induced specifically
 		// for the case of the starting vertex's first expansion.
-		if (h.vertices[adj].effectiveDegree == 1 && !h.vertices[adj].induced)
+		if (r.canExtend(h, lastAddition, adj))
+		{
+			h.induce(adj);
+			r.induce(h, adj);
+			
+			enumerate(h,adj,highestDim + (i == highestDim),state,r);
+			
+			r.reduce(h, adj);
+			h.reduce(adj);
+		}
+	}
+}
+
+// A subtree of the search, given by the path from vertex 0 to its root.
+struct task
+{
+	std::vector<unsigned> path;
+	unsigned highestDim;
+};
+
+// Walks the search tree in the same order as enumerate(), and collects
+// every node with 'depth' vertices as a task. Nodes above that depth that
+// can't grow (closed coils) are tasks too, so that they are ordered among
+// the others the way enumerate() finds them. Other nodes above that depth
+// can still be results (shorter snakes), so the first largest one is kept
+// in 'best'.
+template<class cube, class rules>
+void split(cube& h, rules& r, std::vector<unsigned>& path, unsigned highestDim, unsigned depth,
+	std::vector<task>& tasks, cube& best, counters& stats)
+{
+	// The task's search counts its root, and checks it for a result.
+	if (h.numInduced == depth || !r.canGrow(h, path.back()))
+	{
+		tasks.push_back({path, highestDim});
+		return;
+	}
+	
+	++stats.nodes;
+	
+	if (r.isResult(h, path.back()) && h.numInduced > best.numInduced) best = h;
+	
+	unsigned stop = std::min(cube::dimension,highestDim + 1);
+	for (unsigned i = 0; i < stop; i++)
+	{
+		unsigned adj = cube::adjLists[path.back()][i];
+		
+		if (r.canExtend(h, path.back(), adj))
+		{
+			h.induce(adj);
+			r.induce(h, adj);
+			path.push_back(adj);
+			
+			split(h, r, path, highestDim + (i == highestDim), depth, tasks, best, stats);
+			
+			path.pop_back();
+			r.reduce(h, adj);
+			h.reduce(adj);
+		}
+	}
+}
+
+// Same as enumerate(), but keeps the first largest snake found in 'best'
+// rather than printing, and publishes its size to 'globalMax'.
+template<class cube, class rules>
+void enumerateTask(cube& h, rules& r, unsigned lastAddition, unsigned highestDim,
+	cube& best, std::atomic<unsigned>& globalMax, counters& stats)
+{
+	++stats.nodes;
+	
+	if (r.isResult(h, lastAddition) && h.numInduced > best.numInduced)
+	{
+		best = h;
+		
+		unsigned current = globalMax;
+		while (current < h.numInduced && !globalMax.compare_exchange_weak(current, h.numInduced)) {}
+	}
+	
+	if (!r.canGrow(h, lastAddition)) return;
+	
+	// Ties with other tasks aren't cut, since an earlier task may need
+	// to find the same size for the result to be deterministic.
+	if (useBound)
+	{
+		unsigned bound = r.upperBound(h, lastAddition);
+		
+		if (bound <= best.numInduced || bound < globalMax)
+		{
+			++stats.pruned;
+			return;
+		}
+	}
+	
+	unsigned stop = std::min(cube::dimension,highestDim + 1);
+	for (unsigned i = 0; i < stop; i++)
+	{
+		unsigned adj = cube::adjLists[lastAddition][i];
+		
+		if (r.canExtend(h, lastAddition, adj))
 		{
 			h.induce(adj);
+			r.induce(h, adj);
 			
-			enumerate(h,adj,highestDim + (i == highestDim));
+			enumerateTask(h, r, adj, highestDim + (i == highestDim), best, globalMax, stats);
 			
+			r.reduce(h, adj);
 			h.reduce(adj);
 		}
 	}
 }
 
-int main()
+// Progress of the parallel search, shared between the threads.
+template<class cube>
+struct parallelState
+{
+	std::mutex lock;
+	
+	std::vector<bool> done;
+	counters stats;
+	
+	checkpointTimer timer = { checkpointInterval, 1 };
+};
+
+// Saves the split depth, the counters, the best snake from any finished
+// task (and which task it came from), and the tasks left to do. Tasks
+// that are running are saved as not done, and start over on resume.
+template<class cube, class rules>
+void saveCheckpoint(const parallelState<cube>& state, const rules& r,
+	const std::vector<cube>& results, unsigned depth)
+{
+	checkpointWriter writer(checkpointFile, parallelCheckpoint + (r.variant() << 8), cube::dimension);
+	
+	uint32_t bestTask = results.size();
+	std::vector<uint32_t> remaining;
+	
+	for (uint32_t t = 0; t < results.size(); t++)
+	{
+		if (!state.done[t])
+		{
+			remaining.push_back(t);
+		}
+		else if (bestTask == results.size() || results[t].numInduced > results[bestTask].numInduced)
+		{
+			bestTask = t;
+		}
+	}
+	
+	writer.write<uint32_t>(depth);
+	writer.write(state.stats);
+	writer.write(bestTask);
+	writer.writeCube(bestTask < results.size() ? results[bestTask] : cube());
+	writer.writeVector(remaining);
+	
+	writer.commit();
+}
+
+// Fills in the results and progress from a checkpoint, and returns the
+// tasks that still need to be searched.
+template<class cube, class rules>
+std::vector<uint32_t> loadCheckpoint(parallelState<cube>& state, const rules& r,
+	std::vector<cube>& results, unsigned depth)
+{
+	checkpointReader reader(checkpointFile, parallelCheckpoint + (r.variant() << 8), cube::dimension);
+	
+	if (reader.read<uint32_t>() != depth)
+		throw std::runtime_error("checkpoint " + checkpointFile + " used a different --split");
+	
+	state.stats = reader.read<counters>();
+	
+	uint32_t bestTask = reader.read<uint32_t>();
+	cube best = reader.readCube<cube>();
+	if (bestTask < results.size()) results[bestTask] = best;
+	
+	auto remaining = reader.readVector<uint32_t>();
+	
+	state.done.assign(results.size(), true);
+	for (uint32_t t : remaining)
+	{
+		if (t >= results.size())
+			throw std::runtime_error("checkpoint " + checkpointFile + " has an invalid task");
+		
+		state.done[t] = false;
+	}
+	
+	return remaining;
+}
+
+// 'start' is the rules before anything is on the path. Each task gets a
+// copy of them, and replays its path into it.
+template<class cube, class rules>
+void runParallel(const rules& start, unsigned numThreads, unsigned depth, counters& stats)
+{
+	std::vector<task> tasks;
+	cube prefixBest;
+	
+	// The tasks always come out the same, so they don't need to be saved
+	// in checkpoints, only which ones are done.
+	counters prefixStats;
+	{
+		cube h;
+		rules r = start;
+		std::vector<unsigned> path = {0};
+		h.induce(0);
+		r.induce(h, 0);
+		
+		split(h, r, path, 0, depth, tasks, prefixBest, prefixStats);
+	}
+	
+	// Every result that ends up in prefixBest can still grow, so it is
+	// shorter than the split depth, and smaller than any task's result.
+	// The prefix only matters if no task finds anything.
+	std::vector<cube> results(tasks.size());
+	
+	parallelState<cube> state;
+	std::vector<uint32_t> remaining;
+	
+	if (resume)
+	{
+		remaining = loadCheckpoint(state, start, results, depth);
+	}
+	else
+	{
+		state.stats = prefixStats;
+		state.done.assign(tasks.size(), false);
+		for (uint32_t t = 0; t < tasks.size(); t++) remaining.push_back(t);
+	}
+	
+	std::atomic<unsigned> globalMax = prefixBest.numInduced;
+	for (const auto& result : results)
+	{
+		globalMax = std::max(globalMax.load(), result.numInduced);
+	}
+	
+	workPool pool(numThreads);
+	
+	for (uint32_t t : remaining)
+	{
+		pool.submit([&, t](unsigned)
+		{
+			cube h;
+			rules r = start;
+			for (unsigned v : tasks[t].path)
+			{
+				h.induce(v);
+				r.induce(h, v);
+			}
+			
+			counters taskStats;
+			enumerateTask(h, r, tasks[t].path.back(), tasks[t].highestDim,
+				results[t], globalMax, taskStats);
+			
+			std::lock_guard guard(state.lock);
+			
+			state.done[t] = true;
+			state.stats.nodes += taskStats.nodes;
+			state.stats.pruned += taskStats.pruned;
+			
+			if (!checkpointFile.empty() && state.timer.due())
+			{
+				saveCheckpoint(state, start, results, depth);
+			}
+		});
+	}
+	
+	pool.run();
+	
+	stats = state.stats;
+	
+	// Ties go to the earliest task, which is the one the single threaded
+	// search would have found first.
+	const cube* best = &prefixBest;
+	for (const auto& result : results)
+	{
+		if (result.numInduced > best->numInduced) best = &result;
+	}
+	
+	report(*best);
+}
+
+template<class cube, class rules>
+void run(const options& opts, const rules& start)
 {
-	hypercube<MAX_DIM> h;
+	counters stats;
 	
-	h.induce(0);
+	if (opts.has("threads"))
+	{
+		runParallel<cube>(start, opts.get("threads", 1), opts.get("split", 2 * cube::dimension), stats);
+	}
+	else
+	{
+		searchState<cube> state;
+		
+		if (resume)
+		{
+			loadCheckpoint(state, start);
+			report(state.best);
+		}
+		
+		cube h;
+		rules r = start;
+		
+		h.induce(0);
+		r.induce(h, 0);
+		
+		enumerate(h,0,0,state,r);
+		
+		stats = state.stats;
+		
+		if (countClasses)
+		{
+			std::cout << "Visited " << stats.nodes << " nodes, " << state.classes
+				<< " classes up to symmetry and reversal" << std::endl;
+		}
+		
+		// Every node's form has to be one of the counted ones, and none of
+		// them can be counted twice.
+		if (checkClasses)
+		{
+			std::cout << "Check: " << state.allForms.size() << " canonical forms, "
+				<< state.countedForms.size() << " counted, " << state.duplicates
+				<< " counted twice" << std::endl;
+		}
+	}
+	
+	// The search is done, so the checkpoint is of no use anymore.
+	if (!checkpointFile.empty()) std::filesystem::remove(checkpointFile);
+	
+	if (useBound)
+	{
+		std::cout << "Searched " << stats.nodes << " nodes, pruned "
+			<< stats.pruned << std::endl;
+	}
+}
 
-	enumerate(h,0);
+int main(int argn, char** args)
+{
+	options opts(argn, args);
+	
+	if (auto flag = opts.unknown({"dim", "packed", "threads", "split", "bound",
+		"checkpoint", "interval", "resume", "output", "out", "symmetry", "coil", "spread"}); !flag.empty())
+	{
+		std::cerr << "Error: unknown flag --" << flag << std::endl;
+		return 1;
+	}
+	
+	const unsigned dim = opts.get("dim", 0);
+	
+	if (dim < 1 || dim > 8)
+	{
+		std::cerr << "Error: requires --dim=N, for N from 1 to 8" << std::endl;
+		return 1;
+	}
+	
+	useBound = opts.has("bound");
+	checkpointFile = opts.getString("checkpoint", "");
+	checkpointInterval = opts.get("interval", checkpointInterval);
+	resume = opts.has("resume");
+	countClasses = opts.has("symmetry");
+	checkClasses = opts.getString("symmetry", "") == "check";
+	
+	if (resume && checkpointFile.empty())
+	{
+		std::cerr << "Error: --resume requires --checkpoint=FILE" << std::endl;
+		return 1;
+	}
+	
+	// The class counts are kept by the single threaded search, and aren't
+	// saved in checkpoints.
+	if (countClasses && (opts.has("threads") || !checkpointFile.empty()))
+	{
+		std::cerr << "Error: --symmetry can't be used with --threads or --checkpoint" << std::endl;
+		return 1;
+	}
+	
+	const bool coil = opts.has("coil");
+	const unsigned spread = opts.get("spread", 2);
+	
+	if (opts.has("spread") && (spread < 2 || spread > dim))
+	{
+		std::cerr << "Error: --spread=K requires K from 2 to the dimension" << std::endl;
+		return 1;
+	}
+	
+	// Symmetric coils and spread snakes aren't counted the same way as
+	// snakes, so --symmetry only does snakes.
+	if ((coil && opts.has("spread")) || (countClasses && (coil || spread > 2)))
+	{
+		std::cerr << "Error: only one of --coil, --spread and --symmetry can be used" << std::endl;
+		return 1;
+	}
+	
+	try
+	{
+		resultSink results(opts, dim);
+		sink = &results;
+		
+		// Spread 2 is the same as a snake, so it gets the faster rules.
+		auto withRules = [&]<class cube>()
+		{
+			if (coil)
+				run<cube>(opts, coilRules<cube>());
+			else if (spread > 2)
+				run<cube>(opts, spreadRules<cube>(spread));
+			else
+				run<cube>(opts, snakeRules<cube>());
+		};
+		
+		withDimension<1, 8>(dim, [&]<unsigned N>()
+		{
+			if (opts.has("packed"))
+				withRules.template operator()<packedHypercube<N>>();
+			else
+				withRules.template operator()<hypercube<N>>();
+		});
+	}
+	catch (std::runtime_error& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
 }
@@ -21,11 +21,6 @@ produce a smaller form.
 '<=' is the tricky part.
 */
 
-/*
-I still have this ongoing issue with 'relocation truncated to fit',
-though if the above is true the permutationSet class may not be needed.
-*/
-
 /*
 Another optimization that needs to be done is the greedy approach:
 Only generate forms that are as small as needed. As a made-up example,
@@ -39,20 +34,45 @@ be generated until they are called on, and this carries on down the stack.
 #include <vector>
 #include <iostream>
 #include <array>
-#include <exception>
+#include <optional>
 #include <unordered_set>
-#include <ctime>
-#include "equivRelation.hpp"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <filesystem>
+#include <type_traits>
+#include <unistd.h>
+#include <bitset>
+#include <chrono>
+#include <bit>
+#include <cstdint>
+#include "options.hpp"
+#include "dimension.hpp"
+#include "spill.hpp"
+#include "mappedFile.hpp"
+#include "workPool.hpp"
+#include "resultSink.hpp"
+#include "smallEquivRelation.hpp"
 #include "permutation.hpp"
+#include "canonical.hpp"
+
+// The dimension is given with --dim=N, for N from 1 to 8.
 
-// A macro named MAX_DIM will be compiled in.
-// Size 0 causes issues with template specializations,
-// so we ignore this case.
-#if MAX_DIM == 0
-	#error size should be positive
-#endif
+// Number of pairs of subcubes that fill() has tried to merge.
+unsigned long long pairsTried = 0;
 
-typedef char componentNumType;
+// Set by --regenerate. Classes only keep their canonical form, and fill()
+// generates the images of the second subcube as it goes, searching an index
+// over the first canonical forms instead of over the images. The images get
+// generated again every time they are needed, but memory no longer grows
+// with the size of the symmetry group.
+bool regenerate = false;
+
+// Set by --threads. Each step of fill() is split over this many threads.
+unsigned numThreads = 1;
 
 // Represents, respectively: A non-induced vertex,
 // an induced vertex with 2 neighbors, an induced
@@ -62,149 +82,390 @@ typedef char componentNumType;
 // This simplifies some things later on.
 enum pointType { empty = 0, point = 1, endpoint = 2, midpoint = 3 };
 
-// Returns the new type of a vertex after connecting with another
-// type of vertex.
-pointType getNewType(pointType current, pointType connection)
-{
-	switch (current)
-	{
-		case endpoint:
-			return connection == empty ? endpoint : midpoint;
-		case point:
-			return connection == empty ? point : endpoint;
-		default:
-			return current;
-	}
-}
+// The smallest unsigned type with at least the given number of bits.
+template<unsigned Bits>
+using wordFor = std::conditional_t<Bits <= 8, uint8_t,
+	std::conditional_t<Bits <= 16, uint16_t, uint32_t>>;
 
+// One bit for each vertex of an N dimensional cube, packed into as few
+// bytes as possible. Vertex v is bit v % wordBits of word v / wordBits.
 template<unsigned N>
-struct subcube
+struct vertexPlane
 {
-	// Point type: Represents, respectively: A non-induced vertex,
-	// an induced vertex with 2 neighbors, an induced
-	// vertex with 1 neighbor, an induced vertex with 0
-	// neighbors.
-	// ComponentNumType: Undefined if the vertex is not
-	// induced. Otherwise is the number
-	// of the component it represents.
-	std::array<std::pair<pointType,componentNumType>,(1 << N)> verts;
-	unsigned numComponents;
-	unsigned numVertices;
-	
-	// Throws an exception if the pairing is invalid
-	subcube(const subcube<N-1>& sub1, const subcube<N-1>& sub2)
-	{
-		equivRelation er(sub1.numComponents + sub2.numComponents);
-		
-		for (unsigned i = 0; i < sub1.verts.size(); i++)
-		{
-			// Look for any instances of a midpoint connecting with anything
-			// other than an empty space
-			if ((sub1.verts[i].first == midpoint && sub2.verts[i].first) ||
-			    (sub2.verts[i].first == midpoint && sub1.verts[i].first))
-			{
-				throw std::exception();
-			}
-			
-			// Merge equivalence classes, if needed. Ensure there are no cycles.
-			if (sub1.verts[i].first && sub2.verts[i].first)
+	constexpr static unsigned numVerts = 1 << N;
+	constexpr static unsigned wordBits = numVerts < 32 ? numVerts : 32;
+	constexpr static unsigned numWords = numVerts / wordBits;
+	
+	typedef wordFor<wordBits> word;
+	
+	std::array<word, numWords> words{};
+	
+	bool operator[](unsigned v) const
+	{
+		return (words[v / wordBits] >> (v % wordBits)) & 1;
+	}
+	
+	void set(unsigned v)
+	{
+		words[v / wordBits] |= word(1) << (v % wordBits);
+	}
+	
+	bool none() const
+	{
+		for (word w : words)
+		{
+			if (w) return false;
+		}
+		return true;
+	}
+	
+	// The first vertex that is set, or numVerts if there aren't any.
+	unsigned first() const
+	{
+		for (unsigned i = 0; i < numWords; i++)
+		{
+			if (words[i]) return i * wordBits + std::countr_zero(words[i]);
+		}
+		return numVerts;
+	}
+	
+	unsigned count() const
+	{
+		unsigned result = 0;
+		for (word w : words)
+		{
+			result += std::popcount(w);
+		}
+		return result;
+	}
+	
+	// Number of vertices before v that are set.
+	unsigned rank(unsigned v) const
+	{
+		unsigned result = 0;
+		for (unsigned i = 0; i < v / wordBits; i++)
+		{
+			result += std::popcount(words[i]);
+		}
+		const word below = (word(1) << (v % wordBits)) - 1;
+		return result + std::popcount(word(words[v / wordBits] & below));
+	}
+	
+	// Calls f with each vertex that is set, in order.
+	template<class F>
+	void forEach(F&& f) const
+	{
+		for (unsigned i = 0; i < numWords; i++)
+		{
+			for (word w = words[i]; w; w &= w - 1)
 			{
-				if (er.equivalent(sub1.verts[i].second,
-					sub1.numComponents + sub2.verts[i].second))
-				{
-					throw std::exception();
-				}
-				
-				er.merge(sub1.verts[i].second,
-					sub1.numComponents + sub2.verts[i].second);
+				f(i * wordBits + std::countr_zero(w));
 			}
 		}
-		
-		// Construct the form of the new subcube.
-		const auto& cgl = er.canonicalGroupLabeling();
-		
-		for (unsigned i = 0; i < sub1.verts.size(); i++)
+	}
+	
+	// The same bits as a symmetry's vertexMask, so a symmetry can move
+	// the whole plane at once.
+	typename symmetry<N>::vertexMask toMask() const
+	{
+		typename symmetry<N>::vertexMask result{};
+		for (unsigned i = 0; i < numWords; i++)
 		{
-			unsigned j = i + sub1.verts.size();
-		
-			verts[i].first = getNewType(sub1.verts[i].first, sub2.verts[i].first);
-			verts[j].first = getNewType(sub2.verts[i].first, sub1.verts[i].first);
-			
-			// Empty vertices will have 0 as the component number.
-			verts[i].second = verts[i].first ?
-				cgl[sub1.verts[i].second] : 0;
-			verts[j].second = verts[j].first ?
-				cgl[sub1.numComponents + sub2.verts[i].second] : 0;
+			result[i * wordBits / 64] |= uint64_t(words[i]) << (i * wordBits % 64);
 		}
-		
-		numComponents = er.numComponents();
-		numVertices = sub1.numVertices + sub2.numVertices;
+		return result;
 	}
 	
-	subcube() : numVertices(0) {}
+	static vertexPlane fromMask(const typename symmetry<N>::vertexMask& mask)
+	{
+		vertexPlane result;
+		for (unsigned i = 0; i < numWords; i++)
+		{
+			result.words[i] = word(mask[i * wordBits / 64] >> (i * wordBits % 64));
+		}
+		return result;
+	}
 	
-	subcube(const subcube& other, const permutationSet<N>::permutation& perm)
+	std::bitset<numVerts> toBitset() const
 	{
-		for (unsigned i = 0; i < verts.size(); i++)
+		std::bitset<numVerts> result;
+		for (unsigned i = numWords; i-- > 0;)
 		{
-			verts[i] = other.verts[perm[i]];
+			result <<= wordBits;
+			result |= std::bitset<numVerts>(words[i]);
 		}
-		
-		numComponents = other.numComponents;
-		numVertices = other.numVertices;
+		return result;
 	}
 	
-	constexpr std::strong_ordering operator<=>(const subcube& other) const
+	// Vertices are compared in order, and the first one that differs
+	// decides it, with a set vertex being larger.
+	constexpr std::strong_ordering operator<=>(const vertexPlane& other) const
 	{
-		for (unsigned i = 0; i < verts.size(); i++)
+		for (unsigned i = 0; i < numWords; i++)
 		{
-			bool exists1 = verts[i].first;
-			bool exists2 = other.verts[i].first;
-			
-			if (exists1 != exists2)
-				return exists1 <=> exists2;
+			if (const word diff = words[i] ^ other.words[i])
+			{
+				return (words[i] & (diff & -diff)) ? std::strong_ordering::greater
+					: std::strong_ordering::less;
+			}
 		}
 		return std::strong_ordering::equal;
 	}
 	
-	constexpr bool operator==(const subcube& other) const
+	constexpr bool operator==(const vertexPlane&) const = default;
+	
+	friend vertexPlane operator&(const vertexPlane& p1, const vertexPlane& p2)
 	{
-		for (unsigned i = 0; i < verts.size(); i++)
+		vertexPlane result;
+		for (unsigned i = 0; i < numWords; i++)
 		{
-			bool exists1 = verts[i].first;
-			bool exists2 = other.verts[i].first;
-			
-			if (exists1 != exists2)
-				return false;
+			result.words[i] = p1.words[i] & p2.words[i];
 		}
-		return true;
+		return result;
+	}
+	
+	friend vertexPlane operator|(const vertexPlane& p1, const vertexPlane& p2)
+	{
+		vertexPlane result;
+		for (unsigned i = 0; i < numWords; i++)
+		{
+			result.words[i] = p1.words[i] | p2.words[i];
+		}
+		return result;
+	}
+	
+	friend vertexPlane operator^(const vertexPlane& p1, const vertexPlane& p2)
+	{
+		vertexPlane result;
+		for (unsigned i = 0; i < numWords; i++)
+		{
+			result.words[i] = p1.words[i] ^ p2.words[i];
+		}
+		return result;
+	}
+	
+	// The vertices set in p1 but not p2.
+	friend vertexPlane andNot(const vertexPlane& p1, const vertexPlane& p2)
+	{
+		vertexPlane result;
+		for (unsigned i = 0; i < numWords; i++)
+		{
+			result.words[i] = p1.words[i] & ~p2.words[i];
+		}
+		return result;
 	}
 };
 
-template<>
-struct subcube<0>
+// Puts two planes side by side, the first being the
+// vertices without the top bit, the second with it.
+template<unsigned N>
+vertexPlane<N> concat(const vertexPlane<N-1>& lower, const vertexPlane<N-1>& upper)
 {
-	std::array<std::pair<pointType,componentNumType>,1> verts;
-	unsigned numComponents;
-	unsigned numVertices;
+	vertexPlane<N> result;
+	
+	if constexpr (vertexPlane<N>::numWords == 1)
+	{
+		using word = vertexPlane<N>::word;
+		result.words[0] = word(lower.words[0]) | word(word(upper.words[0]) << (1 << (N-1)));
+	}
+	else
+	{
+		std::copy(lower.words.begin(), lower.words.end(), result.words.begin());
+		std::copy(upper.words.begin(), upper.words.end(),
+			result.words.begin() + lower.words.size());
+	}
+	
+	return result;
+}
+
+template<unsigned N>
+struct subcube
+{
+	constexpr static unsigned numVerts = 1 << N;
+	
+	// Points and endpoints have at most one neighbor that is induced. By
+	// Huang's sensitivity theorem, any set of more than half of the vertices
+	// of a cube (for N >= 2) has a vertex with at least 2 neighbors in the set,
+	// so at most half of the vertices can be points or endpoints. Every
+	// component has at least one of them, so this also bounds the components.
+	constexpr static unsigned maxEnds = N < 2 ? 2 : numVerts / 2;
+	
+	// Enough bits for any component number.
+	constexpr static unsigned componentBits = std::bit_width(maxEnds - 1);
+	
+	// The low and high bits of the pointType of each vertex.
+	vertexPlane<N> low, high;
+	
+	// Component numbers of the points and endpoints, in order of vertex, with
+	// componentBits for each. Midpoints can't meet anything in a merge, so
+	// their component numbers aren't needed (componentOf() can still find them).
+	std::array<uint8_t, (maxEnds * componentBits + 7) / 8> components{};
 	
-	subcube() : numVertices(0) {}
+	pointType type(unsigned v) const
+	{
+		return pointType(low[v] | (high[v] << 1));
+	}
+	
+	vertexPlane<N> inducedVerts() const { return low | high; }
+	vertexPlane<N> midpointVerts() const { return low & high; }
+	
+	// Points and endpoints.
+	vertexPlane<N> endVerts() const { return low ^ high; }
+	
+	// Each component is either a single point or a path with 2 endpoints.
+	unsigned numComponents() const
+	{
+		return andNot(low, high).count() + andNot(high, low).count() / 2;
+	}
+	
+	unsigned numVertices() const { return inducedVerts().count(); }
+	
+	// Component number of the i'th point or endpoint.
+	unsigned endComponent(unsigned i) const
+	{
+		const unsigned bit = i * componentBits;
+		
+		unsigned result = components[bit / 8] >> (bit % 8);
+		if (bit % 8 + componentBits > 8)
+		{
+			result |= components[bit / 8 + 1] << (8 - bit % 8);
+		}
+		return result & ((1 << componentBits) - 1);
+	}
+	
+	// Only works once for each i, the bits start out as 0.
+	void setEndComponent(unsigned i, unsigned component)
+	{
+		const unsigned bit = i * componentBits;
+		
+		components[bit / 8] |= component << (bit % 8);
+		if (bit % 8 + componentBits > 8)
+		{
+			components[bit / 8 + 1] |= component >> (8 - bit % 8);
+		}
+	}
+	
+	// Component number of any induced vertex. A midpoint is found by
+	// following the path it is on until an endpoint.
+	unsigned componentOf(unsigned v) const
+	{
+		unsigned previous = v;
+		while (type(v) == midpoint)
+		{
+			unsigned next = v;
+			for (unsigned bit = 1; bit < numVerts; bit <<= 1)
+			{
+				if ((v ^ bit) != previous && type(v ^ bit)) next = v ^ bit;
+			}
+			previous = v;
+			v = next;
+		}
+		return endComponent(endVerts().rank(v));
+	}
+	
+	// Look for any instances of a midpoint connecting with anything
+	// other than an empty space.
+	static bool compatible(const subcube& sub1, const subcube& sub2)
+	{
+		return ((sub1.midpointVerts() & sub2.inducedVerts()) |
+		        (sub2.midpointVerts() & sub1.inducedVerts())).none();
+	}
+	
+	// Returns nothing if the pairing is invalid.
+	static std::optional<subcube> tryMerge(const subcube<N-1>& sub1, const subcube<N-1>& sub2)
+	{
+		if (!subcube<N-1>::compatible(sub1, sub2))
+		{
+			return std::nullopt;
+		}
+		
+		// These can only be points and endpoints on both sides.
+		const auto overlap = sub1.inducedVerts() & sub2.inducedVerts();
+		const auto ends1 = sub1.endVerts(), ends2 = sub2.endVerts();
+		
+		const unsigned components1 = sub1.numComponents();
+		
+		smallEquivRelation<(1 << N)> er(components1 + sub2.numComponents());
+		
+		// Merge equivalence classes, if needed. Ensure there are no cycles.
+		bool cycle = false;
+		overlap.forEach([&](unsigned i)
+		{
+			const unsigned c1 = sub1.endComponent(ends1.rank(i));
+			const unsigned c2 = components1 + sub2.endComponent(ends2.rank(i));
+			
+			if (er.equivalent(c1, c2)) cycle = true;
+			else er.merge(c1, c2);
+		});
+		
+		if (cycle) return std::nullopt;
+		
+		// Construct the form of the new subcube. Each vertex in the overlap
+		// gets a new neighbor, so a point becomes an endpoint and an endpoint
+		// becomes a midpoint, which is just adding 1 to the type.
+		subcube result;
+		
+		result.low = concat<N>(sub1.low ^ overlap, sub2.low ^ overlap);
+		result.high = concat<N>(sub1.high ^ (sub1.low & overlap),
+			sub2.high ^ (sub2.low & overlap));
+		
+		// The points and endpoints that are left keep their components,
+		// with the new numbering. Endpoints in the overlap are now midpoints.
+		const auto& cgl = er.canonicalGroupLabeling();
+		
+		unsigned next = 0, i1 = 0, i2 = 0;
+		
+		ends1.forEach([&](unsigned v)
+		{
+			if (!(overlap[v] && sub1.high[v]))
+			{
+				result.setEndComponent(next++, cgl[sub1.endComponent(i1)]);
+			}
+			++i1;
+		});
+		ends2.forEach([&](unsigned v)
+		{
+			if (!(overlap[v] && sub2.high[v]))
+			{
+				result.setEndComponent(next++, cgl[components1 + sub2.endComponent(i2)]);
+			}
+			++i2;
+		});
+		
+		return result;
+	}
 	
-	subcube(unsigned v)
+	subcube() = default;
+	
+	// The 2 possible dimension 0 subcubes, with v vertices.
+	subcube(unsigned v) requires (N == 0)
 	{
-		verts[0] = std::make_pair(v == 1 ? point : empty, 0);
-		numComponents = v;
-		numVertices = v;
+		if (v == 1) low.set(0);
 	}
 	
+	// Vertex v of this is vertex sym(v) of other.
+	subcube(const subcube& other, const symmetry<N>& sym) :
+		low(vertexPlane<N>::fromMask(sym.preimage(other.low.toMask()))),
+		high(vertexPlane<N>::fromMask(sym.preimage(other.high.toMask())))
+	{
+		const auto otherEnds = other.endVerts();
+		
+		unsigned next = 0;
+		endVerts().forEach([&](unsigned v)
+		{
+			setEndComponent(next++, other.endComponent(otherEnds.rank(sym(v))));
+		});
+	}
+	
+	// Only the induced vertices are compared.
 	constexpr std::strong_ordering operator<=>(const subcube& other) const
 	{
-		return verts[0] <=> other.verts[0];
+		return inducedVerts() <=> other.inducedVerts();
 	}
 	
 	constexpr bool operator==(const subcube& other) const
 	{
-		return verts[0] == other.verts[0];
+		return inducedVerts() == other.inducedVerts();
 	}
 };
 
@@ -215,9 +476,9 @@ struct subcubeHash
 	std::size_t operator()(const subcube<N>& sc) const
 	{
 		std::size_t hash = 0;
-		for (auto [ptype,compNum] : sc.verts)
+		for (auto word : sc.inducedVerts().words)
 		{
-			hash = 2*hash + (ptype != empty);
+			hash = (hash << 32 | hash >> 32) ^ word;
 		}
 		return hash;
 	}
@@ -226,19 +487,19 @@ struct subcubeHash
 template<unsigned N>
 std::ostream& operator<<(std::ostream& stream, const subcube<N>& sc)
 {
-	for (auto [ptype,compNum] : sc.verts)
+	for (unsigned v = 0; v < sc.numVerts; v++)
 	{
-		if (ptype == empty)
+		if (sc.type(v) == empty)
 		{
 			stream << "_ ";
 		}
 		else
 		{
-			stream << (int)compNum << ' ';
+			stream << sc.componentOf(v) << ' ';
 		}
 	}
-	stream << "| " << sc.numComponents << " components, "
-		<< sc.numVertices << " vertices";
+	stream << "| " << sc.numComponents() << " components, "
+		<< sc.numVertices() << " vertices";
 	
 	return stream;
 }
@@ -251,15 +512,51 @@ struct subcubeClass
 	subcube<N> canonicalForm;
 	std::unordered_set<subcube<N>,subcubeHash<N>> instances;
 	
-	subcubeClass(const subcube<N-1>& sub1, const subcube<N-1>& sub2) :
-		canonicalForm(sub1,sub2)
+	// The form given should already be canonical. Without instances,
+	// only the canonical form is kept.
+	subcubeClass(const subcube<N>& cf, bool withInstances) : canonicalForm(cf)
 	{
-		for (const auto& perm : permutationSet<N>::perms)
+		if (!withInstances) return;
+		
+		symmetryGroup<N>::forEach([&](const symmetry<N>& sym)
 		{
-			auto [iter,inserted] = instances.emplace(canonicalForm,perm);
-			
-			if (inserted && canonicalForm > *iter)
-				throw std::exception();
+			instances.emplace(canonicalForm,sym);
+		});
+	}
+	
+	// Calls f with every distinct image of the canonical form, generated
+	// from the symmetries rather than kept around like the instances. Most
+	// forms have no symmetries other than the identity, so every symmetry
+	// gives a different image. Otherwise the duplicates are thrown out.
+	template<class F>
+	void forEachImage(F&& f) const
+	{
+		const auto stabilizerSize = canonicalizer<N>::canonicalize(
+			canonicalForm.inducedVerts().toBitset()).stabilizerSize;
+		
+		if (stabilizerSize == 1)
+		{
+			symmetryGroup<N>::forEach([&](const symmetry<N>& sym)
+			{
+				f(subcube<N>(canonicalForm,sym));
+			});
+			return;
+		}
+		
+		std::vector<subcube<N>> images;
+		images.reserve(symmetryGroup<N>::size());
+		
+		symmetryGroup<N>::forEach([&](const symmetry<N>& sym)
+		{
+			images.emplace_back(canonicalForm,sym);
+		});
+		
+		std::sort(images.begin(), images.end());
+		images.erase(std::unique(images.begin(), images.end()), images.end());
+		
+		for (const auto& image : images)
+		{
+			f(image);
 		}
 	}
 };
@@ -274,6 +571,178 @@ struct subcubeClass<0>
 	{
 		instances.emplace_back(v);
 	}
+	
+	template<class F>
+	void forEachImage(F&& f) const
+	{
+		for (const auto& instance : instances)
+		{
+			f(instance);
+		}
+	}
+};
+
+// Index over every instance of the classes of one size, so that fill() can
+// find the instances that might merge with a subcube without trying all
+// of them. It's a trie where each level is a vertex, and the children are
+// for that vertex being empty, induced (but not a midpoint), or a midpoint.
+// A midpoint can only meet an empty vertex, so a search only needs to go
+// down the branches that fit with the subcube it was given.
+template<unsigned N>
+class subcubeIndex
+{
+	public:
+	
+	struct entry
+	{
+		const subcube<N>* instance;
+		const subcube<N>* canonicalForm;
+	};
+	
+	subcubeIndex(std::vector<entry>&& e) : entries(std::move(e))
+	{
+		// Sorting by branch puts every subtree in a contiguous range.
+		std::sort(entries.begin(), entries.end(), [](const entry& e1, const entry& e2)
+		{
+			// The first vertex where the branches differ decides it.
+			const unsigned i = ((e1.instance->inducedVerts() ^ e2.instance->inducedVerts()) |
+				(e1.instance->midpointVerts() ^ e2.instance->midpointVerts())).first();
+			
+			return i < subcube<N>::numVerts &&
+				branch(e1.instance->type(i)) < branch(e2.instance->type(i));
+		});
+		
+		build(0, 0, entries.size());
+	}
+	
+	// Calls f with every entry that passes the bitmask checks in tryMerge
+	// when merged with sub. These still need the full check.
+	template<class F>
+	void forCompatible(const subcube<N>& sub, F&& f) const
+	{
+		search(0, 0, sub, f);
+	}
+	
+	std::size_t bytes() const
+	{
+		return entries.capacity() * sizeof(entry) + nodes.capacity() * sizeof(node);
+	}
+	
+	private:
+	
+	// Ranges this small aren't split any further, they are just
+	// checked one at a time.
+	constexpr static unsigned leafSize = 8;
+	
+	struct node
+	{
+		// 0 if there is no child, the root is never a child. If
+		// there are no children at all, this is a leaf.
+		std::array<unsigned,3> children;
+		
+		// The range of entries in this subtree.
+		unsigned begin, end;
+	};
+	
+	std::vector<entry> entries;
+	std::vector<node> nodes;
+	
+	static unsigned branch(pointType p)
+	{
+		return p == empty ? 0 : (p == midpoint ? 2 : 1);
+	}
+	
+	unsigned build(unsigned depth, unsigned begin, unsigned end)
+	{
+		unsigned id = nodes.size();
+		nodes.push_back({ {0,0,0}, begin, end });
+		
+		if (end - begin <= leafSize || depth == (1 << N)) return id;
+		
+		while (begin < end)
+		{
+			unsigned b = branch(entries[begin].instance->type(depth));
+			unsigned last = begin;
+			
+			while (last < end && branch(entries[last].instance->type(depth)) == b)
+			{
+				++last;
+			}
+			
+			// nodes can be moved by the recursive call, so don't hold onto a reference.
+			unsigned child = build(depth + 1, begin, last);
+			nodes[id].children[b] = child;
+			
+			begin = last;
+		}
+		
+		return id;
+	}
+	
+	template<class F>
+	void search(unsigned id, unsigned depth, const subcube<N>& sub, F& f) const
+	{
+		const node& n = nodes[id];
+		
+		if (n.children == std::array<unsigned,3>{0,0,0})
+		{
+			for (unsigned i = n.begin; i < n.end; i++)
+			{
+				const subcube<N>& other = *entries[i].instance;
+				
+				if (subcube<N>::compatible(sub, other))
+				{
+					f(entries[i]);
+				}
+			}
+			return;
+		}
+		
+		// An empty vertex fits with anything, an induced one can't meet a
+		// midpoint, and a midpoint can only meet an empty vertex.
+		const unsigned allowed = 3 - branch(sub.type(depth));
+		
+		for (unsigned b = 0; b < allowed; b++)
+		{
+			if (n.children[b]) search(n.children[b], depth + 1, sub, f);
+		}
+	}
+};
+
+template<unsigned N>
+struct subcubeClassStorage;
+
+// Keeps track of the memory of one size of subcubeClassStorage<N>::sets,
+// and the index over its instances. The classes and their canonical forms
+// always stay in memory, but once the memory budget is used up, the
+// instances (which are most of the memory) are written out to a file as
+// raw subcubes and mapped back in whenever the index needs them again.
+template<unsigned N>
+class subcubeBucket : public spillable
+{
+	static_assert(std::is_trivially_copyable_v<subcube<N>>);
+	
+	public:
+	
+	subcubeBucket(int s) : size(s) {}
+	
+	// Builds the index if it isn't already there.
+	const subcubeIndex<N>& index();
+	
+	std::size_t residentBytes() const override;
+	void spill() override;
+	
+	private:
+	
+	int size;
+	
+	std::optional<subcubeIndex<N>> idx;
+	
+	// Set once the instances have been spilled.
+	std::unique_ptr<mappedFile> file;
+	
+	// The instances of class i are [offsets[i], offsets[i + 1]) in the file.
+	std::vector<unsigned> offsets;
 };
 
 template<unsigned N>
@@ -284,58 +753,144 @@ struct subcubeClassStorage
 	// we can use a vector rather than a set.
 	static inline std::vector<std::vector<subcubeClass<N>>> sets = {};
 	
+	// Created for each size once it has been filled.
+	static inline std::map<int, subcubeBucket<N>> buckets = {};
+	
+	// Instances are only needed to build larger subcubes, so
+	// the top dimension doesn't keep them.
+	static inline bool keepInstances = true;
+	
 	static void findLargestSet();
 	
 	static bool fill(int size);
+	
+	static subcubeBucket<N>& bucket(int size);
 };
 
 template<unsigned N>
-void subcubeClassStorage<N>::findLargestSet()
+subcubeBucket<N>& subcubeClassStorage<N>::bucket(int size)
 {
-	subcubeClassStorage<N-1>::findLargestSet();
-	
-	unsigned largest = 2 * (subcubeClassStorage<N-1>::sets.size() - 1);
+	return buckets.try_emplace(size, size).first->second;
+}
+
+template<unsigned N>
+std::size_t subcubeBucket<N>::residentBytes() const
+{
+	// Rough guess of what each instance costs in an unordered_set.
+	constexpr std::size_t instanceBytes = sizeof(subcube<N>) + 3 * sizeof(void*);
 	
-	sets.resize(largest + 1);
+	std::size_t result = idx ? idx->bytes() : 0;
 	
-	while (fill(largest)) --largest;
+	for (const auto& scc : subcubeClassStorage<N>::sets[size])
+	{
+		result += scc.instances.size() * instanceBytes;
+	}
 	
-	sets.resize(largest + 1);
+	return result;
 }
 
-template<>
-void subcubeClassStorage<0>::findLargestSet()
+template<unsigned N>
+void subcubeBucket<N>::spill()
 {
-	sets = { { subcubeClass<0>(0) }, { subcubeClass<0>(1) } };
+	idx.reset();
+	
+	// Already spilled, the index was all that was left.
+	if (file) return;
+	
+	auto& classes = subcubeClassStorage<N>::sets[size];
+	
+	const std::string path = spillable::directory() + "/siab3_" + std::to_string(N)
+		+ "_" + std::to_string(size) + "_" + std::to_string(getpid()) + ".bin";
+	
+	std::ofstream stream(path, std::ios::binary);
+	
+	unsigned count = 0;
+	for (auto& scc : classes)
+	{
+		offsets.push_back(count);
+		
+		for (const auto& instance : scc.instances)
+		{
+			stream.write(reinterpret_cast<const char*>(&instance), sizeof(instance));
+			++count;
+		}
+		
+		// Just clearing would keep the memory around.
+		decltype(scc.instances)().swap(scc.instances);
+	}
+	offsets.push_back(count);
+	
+	stream.close();
+	
+	if (!stream)
+	{
+		throw std::runtime_error("could not write " + path);
+	}
+	
+	file = std::make_unique<mappedFile>(path);
+	
+	// The mapping keeps the data around, and this way
+	// nothing is left behind if the program is stopped.
+	std::filesystem::remove(path);
 }
 
-template<>
-void subcubeClassStorage<MAX_DIM>::findLargestSet()
+template<unsigned N>
+const subcubeIndex<N>& subcubeBucket<N>::index()
 {
-	subcubeClassStorage<MAX_DIM-1>::findLargestSet();
+	touch();
 	
-	unsigned largest = 2 * (subcubeClassStorage<MAX_DIM-1>::sets.size() - 1);
+	if (idx) return *idx;
 	
-	sets.resize(largest + 1);
+	const auto& classes = subcubeClassStorage<N>::sets[size];
 	
-	while (true)
+	std::vector<typename subcubeIndex<N>::entry> entries;
+	
+	if (file)
 	{
-		fill(largest);
+		const subcube<N>* instances = static_cast<const subcube<N>*>(file->data());
 		
-		for (const auto& scc : sets[largest])
+		for (unsigned i = 0; i < classes.size(); i++)
 		{
-			if (scc.canonicalForm.numComponents == 1)
+			for (unsigned j = offsets[i]; j < offsets[i + 1]; j++)
 			{
-				std::cout << scc.canonicalForm << std::endl;
-				return;
+				entries.push_back({ instances + j, &classes[i].canonicalForm });
 			}
 		}
-		
-		// We don't need to keep these, they are useless now.
-		// TODO: We don't really need to put them anywhere to begin with.
-		sets[largest].clear();
-		--largest;
 	}
+	else
+	{
+		for (const auto& scc : classes)
+		{
+			for (const auto& instance : scc.instances)
+			{
+				entries.push_back({ &instance, &scc.canonicalForm });
+			}
+		}
+	}
+	
+	idx.emplace(std::move(entries));
+	
+	return *idx;
+}
+
+template<unsigned N>
+void subcubeClassStorage<N>::findLargestSet()
+{
+	subcubeClassStorage<N-1>::findLargestSet();
+	
+	unsigned largest = 2 * (subcubeClassStorage<N-1>::sets.size() - 1);
+	
+	sets.resize(largest + 1);
+	
+	while (fill(largest)) --largest;
+	
+	sets.resize(largest + 1);
+}
+
+template<>
+void subcubeClassStorage<0>::findLargestSet()
+{
+	sets = { { subcubeClass<0>(0) }, { subcubeClass<0>(1) } };
 }
 
 template<unsigned N>
@@ -350,6 +905,10 @@ bool subcubeClassStorage<N>::fill(int size)
 	// For brevity
 	const auto& smallerSets = subcubeClassStorage<N-1>::sets;
 	
+	// Counted against the budget while it is being filled, but can't
+	// be spilled until it's done.
+	spillable::pin filling(bucket(size));
+	
 	int maxValue = std::min((int)(smallerSets.size() - 1), size);
 	
 	// Have 2 counters: One starts at the largest value that would be
@@ -365,30 +924,115 @@ bool subcubeClassStorage<N>::fill(int size)
 		subcubeClassStorage<N-1>::fill(s1);
 		subcubeClassStorage<N-1>::fill(s2);
 		
-		for (const auto& set1 : smallerSets[s1])
+		// In the default mode, the canonical form of each class of size s1 is
+		// looked up in the index over the instances of size s2. With --regenerate,
+		// each image of the classes of size s2 is looked up in an index over the
+		// canonical forms of size s1 instead.
+		std::optional<spillable::pin> pinned;
+		std::optional<subcubeIndex<N-1>> formIndex;
+		const subcubeIndex<N-1>* index;
+		
+		if (regenerate)
 		{
-			for (const auto& set2 : smallerSets[s2])
+			std::vector<typename subcubeIndex<N-1>::entry> entries;
+			for (const auto& set1 : smallerSets[s1])
 			{
-				// If the second canonical form is larger, we can prune this,
-				// since swapping them would certainly give a smaller result.
-				if (set1.canonicalForm <= set2.canonicalForm)
+				entries.push_back({ &set1.canonicalForm, &set1.canonicalForm });
+			}
+			
+			index = &formIndex.emplace(std::move(entries));
+		}
+		else
+		{
+			auto& smallerBucket = subcubeClassStorage<N-1>::bucket(s2);
+			pinned.emplace(smallerBucket);
+			
+			index = &smallerBucket.index();
+			spillable::enforceBudget();
+		}
+		
+		const auto& outer = smallerSets[regenerate ? s2 : s1];
+		
+		// The classes are split into chunks, and each chunk keeps what it finds
+		// to itself. They are put together in order afterwards, so the classes
+		// come out in the same order no matter how many threads there are.
+		const std::size_t chunkSize = std::max<std::size_t>(1, outer.size() / (16 * numThreads));
+		const std::size_t numChunks = (outer.size() + chunkSize - 1) / chunkSize;
+		
+		std::vector<std::vector<subcubeClass<N>>> found(numChunks);
+		std::vector<unsigned long long> tried(numChunks, 0);
+		
+		workPool pool(numThreads);
+		
+		for (std::size_t c = 0; c < numChunks; c++)
+		{
+			pool.submit([&, c](unsigned)
+			{
+				auto tryAdd = [&](const subcube<N-1>& sub1, const subcube<N-1>& sub2)
+				{
+					++tried[c];
+					
+					auto merged = subcube<N>::tryMerge(sub1, sub2);
+					
+					// Most merged subcubes aren't canonical, so check that
+					// before generating any of the instances.
+					if (merged && canonicalizer<N>::isCanonical(merged->inducedVerts().toBitset()))
+					{
+						found[c].emplace_back(*merged, keepInstances && !regenerate);
+					}
+				};
+				
+				const std::size_t end = std::min(outer.size(), (c + 1) * chunkSize);
+				
+				for (std::size_t i = c * chunkSize; i < end; i++)
 				{
-					for (const auto& instance2 : set2.instances)
+					const auto& scc = outer[i];
+					
+					if (regenerate)
 					{
-						try
+						scc.forEachImage([&](const subcube<N-1>& image)
 						{
-							sets[size].emplace_back(set1.canonicalForm, instance2);
-						}
-						catch(std::exception& e) {}
+							index->forCompatible(image, [&](const auto& e)
+							{
+								// Same pruning as below.
+								if (*e.canonicalForm <= scc.canonicalForm) tryAdd(*e.canonicalForm, image);
+							});
+						});
+					}
+					else
+					{
+						index->forCompatible(scc.canonicalForm, [&](const auto& e)
+						{
+							// If the second canonical form is larger, we can prune this,
+							// since swapping them would certainly give a smaller result.
+							if (scc.canonicalForm <= *e.canonicalForm) tryAdd(scc.canonicalForm, *e.instance);
+						});
 					}
 				}
-			}
+			});
+		}
+		
+		pool.run();
+		
+		for (std::size_t c = 0; c < numChunks; c++)
+		{
+			pairsTried += tried[c];
+			
+			sets[size].insert(sets[size].end(), std::make_move_iterator(found[c].begin()),
+				std::make_move_iterator(found[c].end()));
+			std::vector<subcubeClass<N>>().swap(found[c]);
+			
+			// Other sizes might need to make room for this one.
+			spillable::enforceBudget();
 		}
 		
 		--s1;
 		++s2;
 	}
 	
+	bucket(size).touch();
+	spillable::enforceBudget();
+	
 	return sets[size].empty();
 }
 
@@ -396,14 +1040,94 @@ bool subcubeClassStorage<N>::fill(int size)
 template<>
 bool subcubeClassStorage<0>::fill(int) { return false; }
 
-int main()
+// The top dimension only needs the largest set with a single component,
+// so it doesn't keep the whole sets around like the other dimensions.
+template<unsigned N>
+void findSolution(resultSink& results)
+{
+	subcubeClassStorage<N-1>::findLargestSet();
+	
+	auto& sets = subcubeClassStorage<N>::sets;
+	subcubeClassStorage<N>::keepInstances = false;
+	
+	unsigned largest = 2 * (subcubeClassStorage<N-1>::sets.size() - 1);
+	
+	sets.resize(largest + 1);
+	
+	while (true)
+	{
+		subcubeClassStorage<N>::fill(largest);
+		
+		for (const auto& scc : sets[largest])
+		{
+			if (scc.canonicalForm.numComponents() == 1)
+			{
+				const auto& form = scc.canonicalForm;
+				const auto induced = form.inducedVerts();
+				
+				results.write(form, [&](unsigned v) { return induced[v]; }, form.numVertices());
+				return;
+			}
+		}
+		
+		// We don't need to keep these, they are useless now.
+		// TODO: We don't really need to put them anywhere to begin with.
+		sets[largest].clear();
+		--largest;
+	}
+}
+
+int main(int argn, char** args)
 {
-	auto startTime = clock();
+	options opts(argn, args);
 	
-	permutationSet<MAX_DIM>::init();
+	if (auto flag = opts.unknown({"dim", "memory", "spill", "regenerate", "threads",
+		"output", "out"}); !flag.empty())
+	{
+		std::cerr << "Error: unknown flag --" << flag << std::endl;
+		return 1;
+	}
+	
+	const unsigned dim = opts.get("dim", 0);
+	
+	if (dim < 1 || dim > 8)
+	{
+		std::cerr << "Error: requires --dim=N, for N from 1 to 8" << std::endl;
+		return 1;
+	}
 	
-	subcubeClassStorage<MAX_DIM>::findLargestSet();
+	// Given in megabytes.
+	spillable::setBudget((std::size_t)opts.get("memory", 0) << 20);
+	spillable::setDirectory(opts.getString("spill", "."));
 	
-	std::cout << "Finished in " << (float)(clock()-startTime)/(CLOCKS_PER_SEC)
-		<< " seconds" << std::endl;
+	regenerate = opts.has("regenerate");
+	numThreads = std::max(opts.get("threads", 1), 1u);
+	
+	// Wall time, since CPU time adds up over the threads.
+	const auto startTime = std::chrono::steady_clock::now();
+	
+	try
+	{
+		resultSink results(opts, dim);
+		
+		withDimension<1, 8>(dim, [&]<unsigned N>() { findSolution<N>(results); });
+	}
+	catch (std::runtime_error& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+	
+	const float seconds = std::chrono::duration<float>(
+		std::chrono::steady_clock::now() - startTime).count();
+	
+	std::cout << "Finished in " << seconds << " seconds" << std::endl;
+	std::cout << "Tried " << pairsTried << " pairs (" << pairsTried / seconds
+		<< " pairs/second)" << std::endl;
+	
+	if (spillable::numSpills() > 0)
+	{
+		std::cout << "Spilled to disk " << spillable::numSpills() << " times, freeing "
+			<< (spillable::bytesSpilled() >> 20) << " MB" << std::endl;
+	}
 }
@@ -1,25 +1,29 @@
 #include <array>
 #include <vector>
-#include <exception>
+#include <optional>
+#include <chrono>
+#include <algorithm>
 #include <unordered_set>
+#include <bitset>
+#include <bit>
+#include "options.hpp"
+#include "dimension.hpp"
 #include "hypercube.hpp"
 #include "permutation.hpp"
+#include "canonical.hpp"
+#include "workPool.hpp"
+#include "resultSink.hpp"
 
 // Empty is a non-induced vertex that is valid to induce
 // Invalid is non-induced, not allowed to induce
 // Induced is an induced vertex.
 enum pointType { empty, invalid, induced };
 
-// MAX_DIM will be compiled in
-
-#if MAX_DIM == 1
-	#error siab4 only supports dimensions 2+
-#endif
-
-#define ARR_SIZE (1 << MAX_DIM)
-
-static inline hypercube<MAX_DIM> h;
+// The dimension is given with --dim=N, for N from 2 to 8.
 
+// The points should be compatible, meaning an induced point
+// is only ever intersected with an empty one. snake::tryMerge
+// checks this for every point at once before intersecting.
 pointType intersect(pointType p1, pointType p2)
 {
 	// If either point is empty, the point just becomes
@@ -27,15 +31,8 @@ pointType intersect(pointType p1, pointType p2)
 	if (p1 == empty) return p2;
 	if (p2 == empty) return p1;
 	
-	// At this point, every point is either induced or
-	// invalid. If both points are invalid, then the
-	// new point is invalid.
-	if (p1 == invalid && p2 == invalid) return invalid;
-	
-	// Otherwise, at least one of the points is induced,
-	// and the other is either induced or invalid. This
-	// invalidates the configuration.
-	throw std::exception();
+	// At this point, both points must be invalid.
+	return invalid;
 }
 
 bool adjacent(unsigned v1, unsigned v2)
@@ -52,12 +49,19 @@ std::ostream& operator<<(std::ostream& stream, pointType p)
 	return stream << (p == empty ? '_' : (p == invalid ? '^' : 'X'));
 }
 
+template<unsigned N>
 struct snake
 {
+	constexpr static unsigned arrSize = 1 << N;
+	
 	unsigned numVertices;
-	std::array<pointType, ARR_SIZE> points;
+	std::array<pointType, arrSize> points;
 	std::array<unsigned,2> endpoints;
 	
+	// Bitmask versions of points, so that most bad merges
+	// can be ruled out without looking at single points.
+	std::bitset<arrSize> inducedVerts, invalidVerts;
+	
 	// Constructor for 1,2,3-snakes. These are all special cases in that
 	// they all have exactly one canonical form of that size, and they
 	// easily constructable. This is also to avoid constructing 2 and 3-snakes
@@ -68,19 +72,19 @@ struct snake
 	{
 		points.fill(empty);
 		
-		if (nv == 1)      endpoints = { ARR_SIZE - 1, ARR_SIZE - 1 };
-		else if (nv == 2) endpoints = { ARR_SIZE - 1, ARR_SIZE - 2 };
-		else              endpoints = { ARR_SIZE - 2, ARR_SIZE - 3 };
+		if (nv == 1)      endpoints = { arrSize - 1, arrSize - 1 };
+		else if (nv == 2) endpoints = { arrSize - 1, arrSize - 2 };
+		else              endpoints = { arrSize - 2, arrSize - 3 };
 		
 		for (unsigned i = 0; i < nv; i++)
 		{
-			points[ARR_SIZE - i - 1] = induced;
+			points[arrSize - i - 1] = induced;
 		}
 		
 		// Mark the vertices around the middle vertex as invalid, except for the endpoints.
 		if (nv == 3)
 		{
-			for (unsigned adj : hypercube<MAX_DIM>::adjLists[ARR_SIZE - 1])
+			for (unsigned adj : hypercube<N>::adjLists[arrSize - 1])
 			{
 				if (points[adj] != induced)
 				{
@@ -88,61 +92,76 @@ struct snake
 				}
 			}
 		}
+		
+		updateMasks();
 	}
 	
-	std::pair<unsigned,unsigned> getMergedEndpoints(const snake& s1, const snake& s2) const
+	snake() = default;
+	
+	// Returns nothing unless exactly one pair of endpoints is adjacent.
+	static std::optional<std::pair<unsigned,unsigned>> getMergedEndpoints(const snake& s1, const snake& s2)
 	{
-		bool matchFound = false;
-		std::pair<unsigned, unsigned> result;
+		std::optional<std::pair<unsigned, unsigned>> result;
 		for (unsigned ep1 : {0u,1u})
 		{
 			for (unsigned ep2 : {0u,1u})
 			{
 				if (adjacent(s1.endpoints[ep1],s2.endpoints[ep2]))
 				{
-					if (matchFound)
-					{
-						throw std::exception();
-					}
+					if (result) return std::nullopt;
 					
 					result = { ep1, ep2 };
-					
-					matchFound = true;
 				}
 			}
 		}
-		if (!matchFound) throw std::exception();
 		
 		return result;
 	}
 	
-	snake(const snake& s1, const snake& s2) :
-		numVertices(s1.numVertices + s2.numVertices)
+	// Returns nothing if the snakes can't be joined.
+	static std::optional<snake> tryMerge(const snake& s1, const snake& s2)
 	{
-		auto [ep1,ep2] = getMergedEndpoints(s1,s2);
+		// An induced point can only meet an empty one.
+		if (((s1.inducedVerts & (s2.inducedVerts | s2.invalidVerts)) |
+		     (s2.inducedVerts & s1.invalidVerts)).any())
+		{
+			return std::nullopt;
+		}
+		
+		auto merged = getMergedEndpoints(s1,s2);
+		if (!merged) return std::nullopt;
 		
-		endpoints[0] = s1.endpoints[!ep1];
-		endpoints[1] = s2.endpoints[!ep2];
+		auto [ep1,ep2] = *merged;
 		
-		for (unsigned i = 0; i < ARR_SIZE; i++)
+		snake result;
+		result.numVertices = s1.numVertices + s2.numVertices;
+		
+		result.endpoints[0] = s1.endpoints[!ep1];
+		result.endpoints[1] = s2.endpoints[!ep2];
+		
+		for (unsigned i = 0; i < arrSize; i++)
 		{
-			points[i] = intersect(s1.points[i], s2.points[i]);
+			result.points[i] = intersect(s1.points[i], s2.points[i]);
 		}
 		
 		// Mark any neighbors of the old endpoints as invalid, since
 		// these endpoints are now midpoints.
-		for (unsigned adj : hypercube<MAX_DIM>::adjLists[s1.endpoints[ep1]])
+		for (unsigned adj : hypercube<N>::adjLists[s1.endpoints[ep1]])
 		{
-			if (points[adj] == empty) points[adj] = invalid;
+			if (result.points[adj] == empty) result.points[adj] = invalid;
 		}
 		
-		for (unsigned adj : hypercube<MAX_DIM>::adjLists[s2.endpoints[ep2]])
+		for (unsigned adj : hypercube<N>::adjLists[s2.endpoints[ep2]])
 		{
-			if (points[adj] == empty) points[adj] = invalid;
+			if (result.points[adj] == empty) result.points[adj] = invalid;
 		}
+		
+		result.updateMasks();
+		
+		return result;
 	}
 	
-	snake(const snake& other, const permutationSet<MAX_DIM>::permutation& perm) :
+	snake(const snake& other, const symmetry<N>::permutation& perm) :
 		numVertices(other.numVertices)
 	{
 		for (unsigned i = 0; i < points.size(); i++)
@@ -150,30 +169,45 @@ struct snake
 			points[perm[i]] = other.points[i];
 		}
 		endpoints = { perm[other.endpoints[0]], perm[other.endpoints[1]] };
+		
+		updateMasks();
 	}
 	
-	std::strong_ordering operator<=>(const snake& other) const
+	void updateMasks()
 	{
 		for (unsigned i = 0; i < points.size(); i++)
 		{
-			bool exists1 = points[i] == induced;
-			bool exists2 = other.points[i] == induced;
-			if (exists1 != exists2)
-				return exists1 <=> exists2;
+			inducedVerts[i] = points[i] == induced;
+			invalidVerts[i] = points[i] == invalid;
 		}
-		return std::strong_ordering::equal;
 	}
 	
-	bool operator==(const snake& other) const
+	// Vertex 0 is compared first, and an induced vertex is larger.
+	std::strong_ordering operator<=>(const snake& other) const
 	{
-		for (unsigned i = 0; i < points.size(); i++)
+		if constexpr (arrSize <= 64)
 		{
-			bool exists1 = points[i] == induced;
-			bool exists2 = other.points[i] == induced;
-			if (exists1 != exists2)
-				return false;
+			const auto diff = (inducedVerts ^ other.inducedVerts).to_ullong();
+			
+			if (diff == 0) return std::strong_ordering::equal;
+			
+			return inducedVerts[std::countr_zero(diff)] ? std::strong_ordering::greater
+				: std::strong_ordering::less;
+		}
+		else
+		{
+			for (unsigned i = 0; i < points.size(); i++)
+			{
+				if (inducedVerts[i] != other.inducedVerts[i])
+					return inducedVerts[i] <=> other.inducedVerts[i];
+			}
+			return std::strong_ordering::equal;
 		}
-		return true;
+	}
+	
+	bool operator==(const snake& other) const
+	{
+		return inducedVerts == other.inducedVerts;
 	}
 	
 	friend std::ostream& operator<<(std::ostream& stream, const snake& snake)
@@ -187,9 +221,10 @@ struct snake
 	}
 };
 
+template<unsigned N>
 struct snakeHash
 {
-	std::size_t operator()(const snake& s) const
+	std::size_t operator()(const snake<N>& s) const
 	{
 		std::size_t hash = 0;
 		for (pointType p : s.points)
@@ -200,110 +235,362 @@ struct snakeHash
 	}
 };
 
+template<unsigned N>
 struct snakeClass
 {
-	snake canonicalForm;
-	std::unordered_set<snake, snakeHash> forms;
+	snake<N> canonicalForm;
+	std::unordered_set<snake<N>, snakeHash<N>> forms;
 	
-	snakeClass(const snake& cf) : canonicalForm(cf)
+	// The form given should already be canonical.
+	snakeClass(const snake<N>& cf) : canonicalForm(cf)
 	{
-		for (const auto& perm : permutationSet<MAX_DIM>::perms)
+		for (const auto& perm : symmetryGroup<N>())
 		{
-			auto [iter,success] = forms.emplace(canonicalForm,perm);
-			
-			if (success && *iter < canonicalForm)
+			forms.emplace(canonicalForm,perm);
+		}
+	}
+};
+
+// The forms of a snake class, bucketed by their endpoints. A merge joins an
+// endpoint of one snake to a neighboring endpoint of the other, so a snake
+// only needs to look in the buckets next to its own endpoints, N each.
+template<unsigned N>
+struct endpointIndex
+{
+	// The forms with each vertex as an endpoint.
+	std::array<std::vector<const snake<N>*>, 1 << N> buckets;
+	
+	endpointIndex(const snakeClass<N>& sc)
+	{
+		for (const auto& form : sc.forms)
+		{
+			buckets[form.endpoints[0]].push_back(&form);
+			if (form.endpoints[1] != form.endpoints[0])
 			{
-				throw std::exception();
+				buckets[form.endpoints[1]].push_back(&form);
 			}
 		}
 	}
 };
 
-void findClassesOfSize(unsigned n, std::array<std::vector<snakeClass>,ARR_SIZE + 1>& snakeClasses)
+// Builds the snake classes of each size bottom up. A snake of size n is
+// made from one of size n/2 and one of size (n+1)/2, so asking for a range
+// of sizes first works out every size they need, and then builds them in
+// waves, where each wave only needs the ones before it. The sizes in a wave
+// are built at the same time. Sizes are only ever built once, including
+// the ones that turn out to have no snakes, so walking the guess up or down
+// only builds the sizes it hasn't seen yet.
+template<unsigned N>
+class snakePlanner
 {
-	if (n <= 3 || !snakeClasses[n].empty()) return;
+	public:
 	
-	unsigned nv1 = n/2, nv2 = (n + 1)/2;
+	constexpr static unsigned maxSize = 1 << N;
 	
-	findClassesOfSize(nv1, snakeClasses);
-	findClassesOfSize(nv2, snakeClasses);
+	snakePlanner(unsigned threads) : numThreads(threads)
+	{
+		for (unsigned i = 1; i <= 3 && i <= maxSize; i++)
+		{
+			sizes[i].classes = { snakeClass<N>(snake<N>(i)) };
+			sizes[i].built = true;
+		}
+	}
+	
+	// Builds every size from lo to hi, and everything they need.
+	void build(unsigned lo, unsigned hi);
+	
+	const std::vector<snakeClass<N>>& classes(unsigned n) const
+	{
+		return sizes[n].classes;
+	}
+	
+	unsigned long long pairsTried() const
+	{
+		unsigned long long result = 0;
+		for (const auto& info : sizes) result += info.pairsTried;
+		return result;
+	}
+	
+	// Prints the time spent on each size that was built, slowest first,
+	// and which sizes were known to be empty without building them.
+	void report(std::ostream&) const;
+	
+	private:
+	
+	struct sizeInfo
+	{
+		std::vector<snakeClass<N>> classes;
+		bool built = false;
+		
+		unsigned long long pairsTried = 0;
+		float seconds = 0;
+		
+		// Merged snakes that were already found from another split.
+		unsigned long long duplicates = 0;
+	};
+	
+	std::array<sizeInfo, maxSize + 1> sizes;
+	unsigned numThreads;
+	
+	// Taking an endpoint off of a snake leaves a smaller snake, so once
+	// a size has no snakes, no larger size has any either. Sizes from
+	// here up are never built, and have no classes.
+	unsigned firstEmpty = maxSize + 1;
+	
+	bool known(unsigned n) const
+	{
+		return sizes[n].built || n >= firstEmpty;
+	}
+	
+	// Both halves should already be built.
+	void buildSize(unsigned n);
+};
+
+template<unsigned N>
+void snakePlanner<N>::build(unsigned lo, unsigned hi)
+{
+	// Halves are always smaller, so going down marks
+	// everything that is needed before it is looked at.
+	std::array<bool, maxSize + 1> needed{};
 	
-	for (const auto& s1Class : snakeClasses[nv1])
+	for (unsigned n = hi; n >= 1; n--)
 	{
-		for (const auto& s2Class : snakeClasses[nv2])
+		if (n >= lo) needed[n] = true;
+		
+		if (needed[n] && !known(n))
+		{
+			needed[n/2] = needed[(n + 1)/2] = true;
+		}
+	}
+	
+	// A size can be built in the wave after both of its halves,
+	// and the sizes that are already known count as wave 0.
+	std::array<unsigned, maxSize + 1> wave{};
+	unsigned numWaves = 0;
+	
+	for (unsigned n = 1; n <= hi; n++)
+	{
+		if (needed[n] && !known(n))
+		{
+			wave[n] = 1 + std::max(wave[n/2], wave[(n + 1)/2]);
+			numWaves = std::max(numWaves, wave[n]);
+		}
+	}
+	
+	for (unsigned w = 1; w <= numWaves; w++)
+	{
+		workPool pool(numThreads);
+		
+		for (unsigned n = 1; n <= hi; n++)
+		{
+			// An earlier wave might have found a smaller empty size.
+			if (wave[n] == w && !known(n))
+			{
+				pool.submit([this, n](unsigned) { buildSize(n); });
+			}
+		}
+		
+		pool.run();
+		
+		for (unsigned n = 1; n <= hi; n++)
+		{
+			if (wave[n] == w && sizes[n].built && sizes[n].classes.empty())
+			{
+				firstEmpty = std::min(firstEmpty, n);
+			}
+		}
+	}
+}
+
+template<unsigned N>
+void snakePlanner<N>::buildSize(unsigned n)
+{
+	const auto startTime = std::chrono::steady_clock::now();
+	
+	sizeInfo& info = sizes[n];
+	
+	// The forms of each class of the second half, bucketed by their endpoints.
+	std::vector<endpointIndex<N>> indexes;
+	for (const auto& s2Class : sizes[(n + 1)/2].classes)
+	{
+		indexes.emplace_back(s2Class);
+	}
+	
+	// The canonical forms found so far. An induced path is the whole snake,
+	// endpoints and invalid vertices included, so the vertices are enough.
+	std::unordered_set<std::bitset<(1 << N)>> found;
+	
+	for (const auto& s1Class : sizes[n/2].classes)
+	{
+		for (const auto& index : indexes)
 		{
 			for (const auto& s1 : s1Class.forms)
 			{
-				for (const auto& s2 : s2Class.forms)
+				// Only forms with an endpoint next to one of s1's can be merged with
+				// it. A form can come up more than once, but only if more than one
+				// pair of endpoints is adjacent, and then it can't be merged anyways.
+				for (unsigned ep : s1.endpoints)
 				{
-					if (s1 < s2)
+					for (unsigned adj : hypercube<N>::adjLists[ep])
 					{
-						try
+						for (const snake<N>* s2 : index.buckets[adj])
 						{
-							snakeClasses[n].emplace_back(snake(s1,s2));
+							if (s1 < *s2)
+							{
+								++info.pairsTried;
+								
+								auto merged = snake<N>::tryMerge(s1,*s2);
+								
+								// Check this before generating any forms, since
+								// most merged snakes aren't canonical.
+								if (merged && canonicalizer<N>::isCanonical(merged->inducedVerts))
+								{
+									// The same snake can be made from different splits.
+									if (found.insert(merged->inducedVerts).second)
+									{
+										info.classes.emplace_back(*merged);
+									}
+									else ++info.duplicates;
+								}
+							}
 						}
-						catch(std::exception&) {}
 					}
+					
+					// A 1-snake has the same endpoint twice.
+					if (s1.endpoints[0] == s1.endpoints[1]) break;
 				}
 			}
 		}
 	}
+	
+	info.built = true;
+	info.seconds = std::chrono::duration<float>(
+		std::chrono::steady_clock::now() - startTime).count();
 }
 
-int main(int argn, char** args)
+template<unsigned N>
+void snakePlanner<N>::report(std::ostream& stream) const
 {
-	if (argn != 2)
+	std::vector<unsigned> built;
+	for (unsigned n = 4; n <= maxSize; n++)
 	{
-		std::cerr << "Error: requires a guess of the answer as an argument"
-			<< std::endl;
-		return 1;
+		if (sizes[n].built) built.push_back(n);
 	}
 	
-	unsigned guess = atoi(args[1]);
-
-	permutationSet<MAX_DIM>::init();
+	std::sort(built.begin(), built.end(), [this](unsigned n1, unsigned n2)
+	{
+		return sizes[n1].seconds > sizes[n2].seconds;
+	});
 	
-	std::array<std::vector<snakeClass>,ARR_SIZE + 1> snakeClasses;
+	stream << "Time per size, slowest first:\n";
+	for (unsigned n : built)
+	{
+		stream << "\tSize " << n << ": " << sizes[n].seconds << " seconds, "
+			<< sizes[n].pairsTried << " pairs, " << sizes[n].classes.size()
+			<< " classes, " << sizes[n].duplicates << " duplicates dropped\n";
+	}
 	
-	for (unsigned i = 1; i <= 3 && i < snakeClasses.size(); i++)
+	if (firstEmpty < maxSize)
 	{
-		snakeClasses[i] = { snakeClass(snake(i)) };
+		stream << "Sizes above " << firstEmpty << " are empty, since size "
+			<< firstEmpty << " is\n";
 	}
+}
+
+template<unsigned N>
+void run(unsigned guess, unsigned last, unsigned numThreads, resultSink& results)
+{
+	const auto startTime = std::chrono::steady_clock::now();
 	
-	findClassesOfSize(guess,snakeClasses);
+	snakePlanner<N> planner(numThreads);
+	const unsigned first = guess;
+	
+	// Everything from the guess to the last size is built in one go, so
+	// only the sizes outside of that need to be walked to one at a time.
+	planner.build(guess, last);
 	
 	unsigned answer;
-	if (snakeClasses[guess].empty())
+	if (planner.classes(guess).empty())
 	{
-		// Overestimate, go down
-		do
+		// Overestimate. Sizes only get emptier going up, so binary search
+		// between the largest size known to have snakes and the guess.
+		unsigned good = 1, bad = guess;
+		for (unsigned n = 2; n < guess; n++)
 		{
-			findClassesOfSize(--guess, snakeClasses);
+			if (!planner.classes(n).empty()) good = n;
+		}
+		
+		while (bad - good > 1)
+		{
+			const unsigned middle = (good + bad) / 2;
+			planner.build(middle, middle);
+			
+			if (planner.classes(middle).empty()) bad = middle;
+			else good = middle;
 		}
-		while(snakeClasses[guess].empty());
-		answer = guess;
+		answer = good;
 	}
 	else
 	{
 		// Underestimate, or exact and need to check one above
-		do
+		while (guess < last && !planner.classes(guess + 1).empty()) ++guess;
+		
+		while (guess < snakePlanner<N>::maxSize && !planner.classes(guess).empty())
+		{
+			++guess;
+			planner.build(guess, guess);
+		}
+		
+		answer = planner.classes(guess).empty() ? guess - 1 : guess;
+	}
+	
+	// Only print the sizes that walking one size at a time from the guess
+	// to the answer would have built, so the output doesn't depend on how
+	// the answer was found. The search above can skip some of their
+	// halves, or build sizes in the middle that the walk never reaches.
+	std::array<bool, snakePlanner<N>::maxSize + 1> shown{};
+	const unsigned lo = std::min(first, answer);
+	const unsigned hi = std::min(std::max({first, answer + 1, last}),
+		snakePlanner<N>::maxSize);
+	
+	for (unsigned n = hi; n >= 1; n--)
+	{
+		if (n >= lo || n <= 3) shown[n] = true;
+		
+		if (shown[n] && n > 3)
 		{
-			findClassesOfSize(++guess, snakeClasses);
+			shown[n/2] = shown[(n + 1)/2] = true;
 		}
-		while(!snakeClasses[guess].empty());
-		answer = guess - 1;
 	}
 	
+	// Anything above the answer is known to be empty, so this only builds
+	// the smaller halves the search didn't need.
+	for (unsigned n = 4; n <= answer; n++)
+	{
+		if (shown[n]) planner.build(n, n);
+	}
+	
+	const float seconds = std::chrono::duration<float>(
+		std::chrono::steady_clock::now() - startTime).count();
+	
+	const unsigned long long pairsTried = planner.pairsTried();
+	
 	std::cout << "Answer = " << answer << std::endl;
+	std::cout << "Tried " << pairsTried << " pairs in " << seconds << " seconds ("
+		<< pairsTried / seconds << " pairs/second)" << std::endl;
 	
-	for (unsigned i = 0; i < snakeClasses.size(); i++)
+	planner.report(std::cout);
+	
+	for (unsigned i = 0; i <= snakePlanner<N>::maxSize; i++)
 	{
-		if (!snakeClasses[i].empty())
+		if (shown[i] && !planner.classes(i).empty())
 		{
-			std::cout << "Size " << i << ":\n";
-			for (const auto& s : snakeClasses[i])
+			results.comment("Size " + std::to_string(i) + ":");
+			for (const auto& s : planner.classes(i))
 			{
-				std::cout << s.canonicalForm << std::endl;
+				const auto& form = s.canonicalForm;
+				results.write(form, [&](unsigned v) { return form.inducedVerts[v]; },
+					i, { form.endpoints[0], form.endpoints[1] });
 				/*
 				for (const auto& form : s.forms)
 				{
@@ -314,3 +601,53 @@ int main(int argn, char** args)
 		}
 	}
 }
+
+int main(int argn, char** args)
+{
+	options opts(argn, args);
+	
+	if (opts.positional().size() != 1)
+	{
+		std::cerr << "Error: requires a guess of the answer as an argument"
+			<< std::endl;
+		return 1;
+	}
+	
+	if (auto flag = opts.unknown({"dim", "upto", "threads", "output", "out"}); !flag.empty())
+	{
+		std::cerr << "Error: unknown flag --" << flag << std::endl;
+		return 1;
+	}
+	
+	const unsigned dim = opts.get("dim", 0);
+	
+	if (dim < 2 || dim > 8)
+	{
+		std::cerr << "Error: requires --dim=N, for N from 2 to 8" << std::endl;
+		return 1;
+	}
+	
+	unsigned guess = atoi(opts.positional()[0].c_str());
+	
+	if (guess < 1 || guess > (1u << dim))
+	{
+		std::cerr << "Error: the guess should be from 1 to " << (1u << dim) << std::endl;
+		return 1;
+	}
+	
+	// --upto=M builds every size from the guess to M at once.
+	const unsigned last = std::clamp(opts.get("upto", guess), guess, 1u << dim);
+	const unsigned numThreads = std::max(opts.get("threads", 1), 1u);
+	
+	try
+	{
+		resultSink results(opts, dim);
+		
+		withDimension<2, 8>(dim, [&]<unsigned N>() { run<N>(guess, last, numThreads, results); });
+	}
+	catch (std::runtime_error& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,57 @@
+#ifndef SMALL_EQUIV_HPP
+#define SMALL_EQUIV_HPP
+
+#include <array>
+#include <cstdint>
+
+// A cut down version of equivRelation for when there is a known, small
+// upper bound on the number of elements. Everything is stored inline,
+// so constructing one never allocates. Only supports the parts of the
+// interface needed for merging.
+template<unsigned Capacity>
+class smallEquivRelation
+{
+	static_assert(Capacity <= 256, "elements must fit in a uint8_t");
+	
+	public:
+	
+	smallEquivRelation(unsigned);
+	
+	// Merge two elements
+	void merge(unsigned, unsigned);
+	
+	// Checks if two elements are equivalent
+	bool equivalent(unsigned, unsigned) const;
+	
+	// Returns the canonical group labeling of this. The labels in the
+	// reference change with any merge after this.
+	const std::array<uint8_t,Capacity>& canonicalGroupLabeling() const;
+	
+	// Returns the number of elements in this ER.
+	unsigned size() const;
+	
+	// Returns the number of non-equivalent components of this ER.
+	unsigned numComponents() const;
+	
+	private:
+	
+	unsigned leader(unsigned) const;
+	
+	// Mutable, since the leader function should appear
+	// const, but technically isn't.
+	mutable std::array<uint8_t,Capacity> boss;
+	
+	// Union by rank rather than size, so this fits in a uint8_t as well.
+	std::array<uint8_t,Capacity> rank;
+	
+	mutable std::array<uint8_t,Capacity> cgl;
+	mutable bool changed;
+	
+	unsigned numElements, components;
+	
+	void updateCGL() const;
+};
+
+#include "smallEquivRelation.tpp"
+
+#endif
@@ -0,0 +1,92 @@
+#include "smallEquivRelation.hpp"
+
+template<unsigned Capacity>
+smallEquivRelation<Capacity>::smallEquivRelation(unsigned size) :
+	changed(true), numElements(size), components(size)
+{
+	for (unsigned i = 0; i < size; i++)
+	{
+		boss[i] = i;
+		rank[i] = 0;
+	}
+}
+
+template<unsigned Capacity>
+void smallEquivRelation<Capacity>::merge(unsigned x, unsigned y)
+{
+	unsigned leadX = leader(x), leadY = leader(y);
+	
+	if (leadX != leadY)
+	{
+		if (rank[leadX] < rank[leadY])
+		{
+			boss[leadX] = leadY;
+		}
+		else
+		{
+			boss[leadY] = leadX;
+			if (rank[leadX] == rank[leadY]) ++rank[leadX];
+		}
+		--components;
+		changed = true;
+	}
+}
+
+template<unsigned Capacity>
+bool smallEquivRelation<Capacity>::equivalent(unsigned x, unsigned y) const
+{
+	return leader(x) == leader(y);
+}
+
+template<unsigned Capacity>
+unsigned smallEquivRelation<Capacity>::leader(unsigned x) const
+{
+	if (boss[x] == x) return x;
+	
+	return (boss[x] = leader(boss[x]));
+}
+
+template<unsigned Capacity>
+const std::array<uint8_t,Capacity>& smallEquivRelation<Capacity>::canonicalGroupLabeling() const
+{
+	updateCGL();
+	
+	return cgl;
+}
+
+template<unsigned Capacity>
+unsigned smallEquivRelation<Capacity>::size() const
+{
+	return numElements;
+}
+
+template<unsigned Capacity>
+unsigned smallEquivRelation<Capacity>::numComponents() const
+{
+	return components;
+}
+
+template<unsigned Capacity>
+void smallEquivRelation<Capacity>::updateCGL() const
+{
+	if (!changed) return;
+	
+	changed = false;
+	
+	// Leaders are labeled the first time one of their group is seen,
+	// so mark them all as not seen yet.
+	std::array<bool,Capacity> seen {};
+	
+	unsigned group_num = 0;
+	for (unsigned i = 0; i < numElements; i++)
+	{
+		unsigned lead = leader(i);
+		if (!seen[lead])
+		{
+			seen[lead] = true;
+			cgl[lead] = group_num++;
+		}
+		
+		cgl[i] = cgl[lead];
+	}
+}
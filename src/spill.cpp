@@ -0,0 +1,94 @@
+#include <algorithm>
+#include "spill.hpp"
+
+unsigned long long spillable::useCounter = 0;
+
+std::size_t spillable::budget = 0;
+std::string spillable::dir = ".";
+
+unsigned spillable::spills = 0;
+std::size_t spillable::spilled = 0;
+
+std::vector<spillable*>& spillable::all()
+{
+	static auto* result = new std::vector<spillable*>();
+	return *result;
+}
+
+spillable::spillable() : pins(0), lastUsed(useCounter++)
+{
+	all().push_back(this);
+}
+
+spillable::~spillable()
+{
+	all().erase(std::find(all().begin(), all().end(), this));
+}
+
+void spillable::touch()
+{
+	lastUsed = useCounter++;
+}
+
+void spillable::setBudget(std::size_t bytes)
+{
+	budget = bytes;
+}
+
+void spillable::setDirectory(const std::string& d)
+{
+	dir = d;
+}
+
+const std::string& spillable::directory()
+{
+	return dir;
+}
+
+void spillable::enforceBudget()
+{
+	if (budget == 0) return;
+	
+	std::size_t total = 0;
+	for (const spillable* s : all())
+	{
+		total += s->residentBytes();
+	}
+	
+	if (total <= budget) return;
+	
+	std::vector<spillable*> candidates;
+	for (spillable* s : all())
+	{
+		if (s->pins == 0) candidates.push_back(s);
+	}
+	
+	std::sort(candidates.begin(), candidates.end(),
+		[](const spillable* s1, const spillable* s2) { return s1->lastUsed < s2->lastUsed; });
+	
+	for (spillable* s : candidates)
+	{
+		if (total <= budget) break;
+		
+		const std::size_t before = s->residentBytes();
+		if (before == 0) continue;
+		
+		s->spill();
+		
+		const std::size_t freed = before - std::min(before, s->residentBytes());
+		total -= freed;
+		
+		++spills;
+		spilled += freed;
+	}
+}
+
+unsigned spillable::numSpills()
+{
+	return spills;
+}
+
+std::size_t spillable::bytesSpilled()
+{
+	return spilled;
+}
@@ -0,0 +1,81 @@
+#ifndef SPILL_HPP
+#define SPILL_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// Base class for anything that can free most of its memory by writing
+// it out to disk. Every spillable is kept track of, and whenever their
+// total goes over the memory budget, the least recently used ones are
+// spilled until it fits again. With no budget (the default), nothing
+// is ever spilled. Pinned spillables still count towards the total, so
+// the budget can't go below what is pinned at any one time.
+class spillable
+{
+	public:
+	
+	spillable();
+	virtual ~spillable();
+	
+	// Everything is tracked by address, so these can't be moved.
+	spillable(const spillable&) = delete;
+	spillable& operator=(const spillable&) = delete;
+	
+	// An estimate of how much memory this is using right now.
+	virtual std::size_t residentBytes() const = 0;
+	
+	// Writes out and frees as much as it can.
+	virtual void spill() = 0;
+	
+	// Marks this as the most recently used.
+	void touch();
+	
+	// While a pin exists, what it pins won't be spilled.
+	class pin
+	{
+		public:
+		
+		pin(spillable& s) : pinned(s) { ++pinned.pins; }
+		~pin() { --pinned.pins; }
+		
+		pin(const pin&) = delete;
+		pin& operator=(const pin&) = delete;
+		
+		private:
+		
+		spillable& pinned;
+	};
+	
+	// In bytes, 0 for no limit.
+	static void setBudget(std::size_t bytes);
+	
+	// Where spilled data is written to.
+	static void setDirectory(const std::string&);
+	static const std::string& directory();
+	
+	// Spills the least recently used unpinned spillables
+	// until the total fits in the budget.
+	static void enforceBudget();
+	
+	static unsigned numSpills();
+	static std::size_t bytesSpilled();
+	
+	private:
+	
+	unsigned pins;
+	unsigned long long lastUsed;
+	
+	// Never destroyed, since spillables can be static objects that
+	// are destroyed in any order at exit.
+	static std::vector<spillable*>& all();
+	static unsigned long long useCounter;
+	
+	static std::size_t budget;
+	static std::string dir;
+	
+	static unsigned spills;
+	static std::size_t spilled;
+};
+
+#endif
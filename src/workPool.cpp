@@ -0,0 +1,151 @@
+#include <thread>
+#include "workPool.hpp"
+
+// Index of the pool thread running on this thread, used so tasks
+// submitted from inside a task end up on the submitting thread's queue.
+static thread_local int currentThread = -1;
+
+workPool::workPool(unsigned numThreads) :
+	queues(std::max(numThreads, 1u)), pending(0), queued(0), nextQueue(0) {}
+
+void workPool::submit(task t)
+{
+	unsigned index = currentThread >= 0 ? currentThread : nextQueue++ % queues.size();
+	
+	// The counts go up with the task under the state lock, so that
+	// whoever takes it can't count it as done before it was counted.
+	{
+		std::lock_guard state(stateLock);
+		std::lock_guard guard(queues[index].lock);
+		
+		queues[index].tasks.push_back(std::move(t));
+		++pending;
+		++queued;
+	}
+	wake.notify_one();
+}
+
+void workPool::run()
+{
+	std::vector<std::thread> threads;
+	
+	for (unsigned i = 1; i < queues.size(); i++)
+	{
+		threads.emplace_back(&workPool::work, this, i);
+	}
+	
+	work(0);
+	
+	for (auto& t : threads) t.join();
+	
+	// Clear the error first, so the pool can be run again.
+	std::exception_ptr thrown;
+	std::swap(thrown, error);
+	if (thrown) std::rethrow_exception(thrown);
+}
+
+unsigned workPool::size() const
+{
+	return queues.size();
+}
+
+bool workPool::pop(unsigned index, task& t)
+{
+	{
+		std::lock_guard guard(queues[index].lock);
+		
+		if (queues[index].tasks.empty()) return false;
+		
+		t = std::move(queues[index].tasks.back());
+		queues[index].tasks.pop_back();
+	}
+	
+	taken();
+	return true;
+}
+
+bool workPool::steal(unsigned index, task& t)
+{
+	// Start with the next thread over, so thieves spread out.
+	for (unsigned i = 1; i < queues.size(); i++)
+	{
+		auto& victim = queues[(index + i) % queues.size()];
+		
+		{
+			std::lock_guard guard(victim.lock);
+			
+			if (victim.tasks.empty()) continue;
+			
+			t = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+		}
+		
+		taken();
+		return true;
+	}
+	return false;
+}
+
+void workPool::taken()
+{
+	std::lock_guard guard(stateLock);
+	--queued;
+}
+
+void workPool::finished()
+{
+	bool done;
+	{
+		std::lock_guard guard(stateLock);
+		done = --pending == 0;
+	}
+	if (done) wake.notify_all();
+}
+
+void workPool::work(unsigned index)
+{
+	currentThread = index;
+	
+	task t;
+	
+	// Tasks can only be added by running tasks (or before running), so
+	// once nothing is pending, nothing more can show up.
+	while (true)
+	{
+		if (pop(index, t) || steal(index, t))
+		{
+			bool failed;
+			{
+				std::lock_guard guard(stateLock);
+				failed = error != nullptr;
+			}
+			
+			// Once a task has thrown, the rest are only taken off the
+			// queues, so that run() can return.
+			if (!failed)
+			{
+				try
+				{
+					t(index);
+				}
+				catch (...)
+				{
+					std::lock_guard guard(stateLock);
+					if (!error) error = std::current_exception();
+				}
+			}
+			
+			finished();
+		}
+		else
+		{
+			// A task queued between the failed steal and here is still
+			// counted in 'queued', so the wakeup can't be missed.
+			std::unique_lock lock(stateLock);
+			if (pending == 0) break;
+			wake.wait(lock, [this] { return pending == 0 || queued > 0; });
+		}
+	}
+	
+	currentThread = -1;
+}
@@ -0,0 +1,69 @@
+#ifndef WORK_POOL_HPP
+#define WORK_POOL_HPP
+
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+// A pool of threads with work stealing. Each thread has its own deque of
+// tasks, takes work from the back of it, and when it runs out, steals
+// from the front of another thread's deque. Tasks are given the index
+// of the thread running them, so they can use per-thread state.
+class workPool
+{
+	public:
+	
+	typedef std::function<void(unsigned)> task;
+	
+	workPool(unsigned numThreads);
+	
+	// Adds a task. Initial tasks are spread round-robin over the threads,
+	// tasks added from within a task go to the thread running it.
+	void submit(task);
+	
+	// Runs all tasks, including those submitted while running, and
+	// returns once every one has finished. The calling thread is used
+	// as thread 0. If a task throws, the tasks that haven't started yet
+	// are dropped, and the first exception is rethrown from here.
+	void run();
+	
+	unsigned size() const;
+	
+	private:
+	
+	struct queue
+	{
+		std::mutex lock;
+		std::deque<task> tasks;
+	};
+	
+	bool pop(unsigned, task&);
+	bool steal(unsigned, task&);
+	
+	void work(unsigned);
+	
+	// Called after a task is taken from a queue, and after it finishes.
+	void taken();
+	void finished();
+	
+	std::vector<queue> queues;
+	
+	// Guards the counts and the error below. Idle threads wait on
+	// 'wake' until a task is queued or everything is done.
+	std::mutex stateLock;
+	std::condition_variable wake;
+	
+	// Tasks submitted but not yet finished, and those still in a queue.
+	unsigned long long pending;
+	unsigned long long queued;
+	
+	// The first exception thrown by a task in this run.
+	std::exception_ptr error;
+	
+	unsigned nextQueue;
+};
+
+#endif